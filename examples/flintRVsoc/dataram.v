@@ -0,0 +1,30 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+module dataram (
+    input                           i_clk, i_we,
+    input       [3:0]               i_byteEn,
+    input       [ADDR_WIDTH-1:0]    i_addr,     // Word address
+    input       [31:0]              i_data,
+    output reg  [31:0]              o_data
+);
+    parameter ADDR_WIDTH = 8;
+    reg [31:0] ram [2**ADDR_WIDTH-1:0];
+
+    integer i;
+    initial begin
+        for (i=0; i<2**ADDR_WIDTH; i=i+1) begin
+            ram[i] = 32'd0;
+        end
+    end
+
+    // Byte-strobed "synchronous RAM" (maps to BRAM byte-write enables)
+    always @(posedge i_clk) begin
+        if (i_we && i_byteEn[0]) ram[i_addr][7:0]   <= i_data[7:0];
+        if (i_we && i_byteEn[1]) ram[i_addr][15:8]  <= i_data[15:8];
+        if (i_we && i_byteEn[2]) ram[i_addr][23:16] <= i_data[23:16];
+        if (i_we && i_byteEn[3]) ram[i_addr][31:24] <= i_data[31:24];
+        o_data <= ram[i_addr];
+    end
+
+endmodule
@@ -7,6 +7,7 @@ module flintRVsoc (
     output  o_led
 );
     wire [31:0] pcOut, dataAddr, dataOut, bootRomOut, dataMemOut;
+    wire  [3:0] byteEn;
     reg  [31:0] dataIn;
     wire loadReq, storeReq, imem_data_sel, dmem_data_sel, led_data_sel;
 
@@ -35,17 +36,16 @@ module flintRVsoc (
         .i_addr                 ({2'd0, pcOut[9:2]}),
         .o_data                 (bootRomOut)
     );
-    // Data memory (core_generated.v)
-    DualPortRam #(
-        .XLEN(32),
-        .ADDR_WIDTH(10) // 1KB
+    // Data memory (dataram.v)
+    dataram #(
+        .ADDR_WIDTH(8) // 1KB
     ) DMEM (
         .i_clk                  (i_clk),
         .i_we                   (dmem_data_sel && storeReq),
-        .i_dataIn               (dataOut),
-        .i_rAddr                (dataAddr[9:0]),
-        .i_wAddr                (dataAddr[9:0]),
-        .o_q                    (dataMemOut)
+        .i_byteEn               (byteEn),
+        .i_addr                 (dataAddr[9:2]),
+        .i_data                 (dataOut),
+        .o_data                 (dataMemOut)
     );
     // CPU (core_generated.v)
     CPU CPU_unit (
@@ -59,7 +59,8 @@ module flintRVsoc (
         .o_loadReq              (loadReq),
         .o_pcOut                (pcOut),
         .o_dataAddr             (dataAddr),
-        .o_dataOut              (dataOut)
+        .o_dataOut              (dataOut),
+        .o_byteEn               (byteEn)
     );
 
     // Output MMIO led reg
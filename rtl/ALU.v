@@ -10,7 +10,8 @@ module ALU (
   output reg    [XLEN-1:0]          o_result
 );
     parameter   XLEN = 32;
-    localparam  ALU_OP_WIDTH = 5;
+    parameter   ZB_EXT = 0; // 1: Zba/Zbb bit-manipulation ops
+    localparam  ALU_OP_WIDTH = 6;
 
     /* verilator lint_off UNUSED */
     // TODO: Bits of signal are not used: 'ALU_ADDER_result'[32]
@@ -19,13 +20,15 @@ module ALU (
     wire [XLEN-1:0] B_in            = i_op == `ALU_OP_ADD4A ? CONST_4 : SUB ? ~i_b : i_b;
     wire [XLEN-1:0] ALU_XOR_result  = i_a ^ i_b;
     wire [XLEN-1:0] CONST_4         = {{(XLEN-3){1'b0}}, 3'd4};
-    wire SUB                        = ~i_op[4] && i_op[3]; // Encoding 01000-01111 of ALU exec/op to SUB on adder unit
+    wire SUB                        = ~i_op[5] && ~i_op[4] && i_op[3]; // Encoding 001000-001111 of ALU exec/op to SUB on adder unit
     wire SLT                        = $signed(i_a) < $signed(i_b);
     wire SLTU                       = i_a < i_b;
 
+    reg  [XLEN-1:0] ZB_result;
+
     always @(*) begin
         case (i_op)
-            default         : o_result = ALU_ADDER_result[31:0];
+            default         : o_result = (ZB_EXT == 1) && i_op[5] ? ZB_result : ALU_ADDER_result[31:0];
             `ALU_OP_AND     : o_result = i_a & i_b;
             `ALU_OP_OR      : o_result = i_a | i_b;
             `ALU_OP_XOR     : o_result = ALU_XOR_result;
@@ -41,4 +44,59 @@ module ALU (
             `ALU_OP_SGTEU   : o_result = {31'd0, ~SLTU};
         endcase
     end
+
+    // Zba/Zbb (encodings 1xxxxx)
+    function [XLEN-1:0] clz(input [XLEN-1:0] x);
+        integer k;
+        begin
+            clz = XLEN;
+            for (k=0; k<XLEN; k=k+1) begin
+                if (x[k]) clz = XLEN-1-k;
+            end
+        end
+    endfunction
+    function [XLEN-1:0] ctz(input [XLEN-1:0] x);
+        integer k;
+        begin
+            ctz = XLEN;
+            for (k=XLEN-1; k>=0; k=k-1) begin
+                if (x[k]) ctz = k;
+            end
+        end
+    endfunction
+    function [XLEN-1:0] cpop(input [XLEN-1:0] x);
+        integer k;
+        begin
+            cpop = {XLEN{1'b0}};
+            for (k=0; k<XLEN; k=k+1) begin
+                cpop = cpop + {{(XLEN-1){1'b0}}, x[k]};
+            end
+        end
+    endfunction
+    wire [5:0] ROT_COMP     = 6'd32 - {1'b0, i_b[4:0]}; // Complementary rotate amount
+    always @(*) begin
+        case (i_op)
+            `ALU_OP_ANDN    : ZB_result = i_a & ~i_b;
+            `ALU_OP_ORN     : ZB_result = i_a | ~i_b;
+            `ALU_OP_XNOR    : ZB_result = ~ALU_XOR_result;
+            `ALU_OP_CLZ     : ZB_result = clz(i_a);
+            `ALU_OP_CTZ     : ZB_result = ctz(i_a);
+            `ALU_OP_CPOP    : ZB_result = cpop(i_a);
+            `ALU_OP_MIN     : ZB_result = SLT  ? i_a : i_b;
+            `ALU_OP_MAX     : ZB_result = SLT  ? i_b : i_a;
+            `ALU_OP_MINU    : ZB_result = SLTU ? i_a : i_b;
+            `ALU_OP_MAXU    : ZB_result = SLTU ? i_b : i_a;
+            `ALU_OP_SEXTB   : ZB_result = {{24{i_a[7]}},  i_a[7:0]};
+            `ALU_OP_SEXTH   : ZB_result = {{16{i_a[15]}}, i_a[15:0]};
+            `ALU_OP_ZEXTH   : ZB_result = {16'd0, i_a[15:0]};
+            `ALU_OP_ROL     : ZB_result = (i_a << i_b[4:0]) | (i_a >> ROT_COMP);
+            `ALU_OP_ROR     : ZB_result = (i_a >> i_b[4:0]) | (i_a << ROT_COMP);
+            `ALU_OP_ORCB    : ZB_result = {{8{|i_a[31:24]}}, {8{|i_a[23:16]}}, {8{|i_a[15:8]}}, {8{|i_a[7:0]}}};
+            `ALU_OP_REV8    : ZB_result = {i_a[7:0], i_a[15:8], i_a[23:16], i_a[31:24]};
+            `ALU_OP_SH1ADD  : ZB_result = {i_a[30:0], 1'b0}  + i_b;
+            `ALU_OP_SH2ADD  : ZB_result = {i_a[29:0], 2'b00} + i_b;
+            `ALU_OP_SH3ADD  : ZB_result = {i_a[28:0], 3'b000} + i_b;
+            default         : ZB_result = {XLEN{1'b0}};
+        endcase
+    end
 endmodule
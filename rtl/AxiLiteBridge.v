@@ -0,0 +1,108 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+module AxiLiteBridge (
+    input                   i_clk,
+                            i_rst,
+    // Core port (req/valid)
+    input                   i_req,
+                            i_we,
+    input       [XLEN-1:0]  i_addr,
+                            i_data,
+    input       [3:0]       i_byteEn,
+    output                  o_valid,
+    output      [XLEN-1:0]  o_data,
+    // AXI4-Lite master port
+    output      [XLEN-1:0]  o_axi_awaddr,
+    output      [2:0]       o_axi_awprot,
+    output                  o_axi_awvalid,
+    input                   i_axi_awready,
+    output      [XLEN-1:0]  o_axi_wdata,
+    output      [3:0]       o_axi_wstrb,
+    output                  o_axi_wvalid,
+    input                   i_axi_wready,
+    /* verilator lint_off UNUSED */
+    input       [1:0]       i_axi_bresp,
+    /* verilator lint_on UNUSED */
+    input                   i_axi_bvalid,
+    output                  o_axi_bready,
+    output      [XLEN-1:0]  o_axi_araddr,
+    output      [2:0]       o_axi_arprot,
+    output                  o_axi_arvalid,
+    input                   i_axi_arready,
+    input       [XLEN-1:0]  i_axi_rdata,
+    /* verilator lint_off UNUSED */
+    input       [1:0]       i_axi_rresp,
+    /* verilator lint_on UNUSED */
+    input                   i_axi_rvalid,
+    output                  o_axi_rready
+);
+    parameter   XLEN        = 32;
+    parameter   INSTR_PORT  = 0; // 1: Instruction fetch port (tags accesses w/ AxPROT[2])
+
+    // FSM states
+    localparam  S_IDLE      = 2'd0;
+    localparam  S_ADDR      = 2'd1; // Address (and write data) handshake
+    localparam  S_RESP      = 2'd2; // Read data / write response handshake
+
+    reg [1:0]           r_state /*verilator public*/;
+    reg                 r_we, r_awDone, r_wDone;
+    reg [XLEN-1:0]      r_addr, r_data;
+    reg [3:0]           r_strb;
+    wire                respValid   = r_we ? i_axi_bvalid : i_axi_rvalid;
+
+    always @(posedge i_clk) begin
+        if (i_rst) begin
+            r_state <= S_IDLE;
+        end else begin
+            case (r_state)
+                S_IDLE  : begin
+                    if (i_req) begin
+                        r_state     <= S_ADDR;
+                        r_we        <= i_we;
+                        r_addr      <= i_addr;
+                        r_data      <= i_data;
+                        r_strb      <= i_byteEn;
+                        r_awDone    <= 1'b0;
+                        r_wDone     <= 1'b0;
+                    end
+                end
+                S_ADDR  : begin
+                    if (r_we) begin
+                        // AW and W channels complete independently
+                        r_awDone    <= r_awDone || i_axi_awready;
+                        r_wDone     <= r_wDone  || i_axi_wready;
+                        r_state     <= ((r_awDone || i_axi_awready) && (r_wDone || i_axi_wready)) ? S_RESP : S_ADDR;
+                    end else begin
+                        r_state     <= i_axi_arready ? S_RESP : S_ADDR;
+                    end
+                end
+                S_RESP  : begin
+                    r_state         <= respValid ? S_IDLE : S_RESP;
+                end
+                default : r_state   <= S_IDLE;
+            endcase
+        end
+    end
+
+    // Write channels
+    assign o_axi_awaddr     = r_addr;
+    assign o_axi_awprot     = 3'b000;
+    assign o_axi_awvalid    = (r_state == S_ADDR) && r_we && ~r_awDone;
+    assign o_axi_wdata      = r_data;
+    assign o_axi_wstrb      = r_strb;
+    assign o_axi_wvalid     = (r_state == S_ADDR) && r_we && ~r_wDone;
+    assign o_axi_bready     = (r_state == S_RESP) && r_we;
+    // Read channels
+    assign o_axi_araddr     = r_addr;
+    assign o_axi_arprot     = {INSTR_PORT == 1, 2'b00};
+    assign o_axi_arvalid    = (r_state == S_ADDR) && ~r_we;
+    assign o_axi_rready     = (r_state == S_RESP) && ~r_we;
+
+    // Drop responses for a request the core no longer wants (e.g. fetch redirected)
+    assign o_valid          = (r_state == S_RESP) && respValid && i_req && (i_addr == r_addr);
+    assign o_data           = i_axi_rdata;
+
+endmodule
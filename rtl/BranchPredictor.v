@@ -0,0 +1,94 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+module BranchPredictor (
+    input                   i_clk,
+                            i_rst,
+    // Fetch (predict) port
+    input       [XLEN-1:0]  i_fetchPC,
+    output                  o_predTaken,
+    output      [XLEN-1:0]  o_predTarget,
+    // Resolve (update) port
+    input                   i_update,
+                            i_updateBra,
+                            i_updateJmp,
+                            i_updateTaken,
+    input       [XLEN-1:0]  i_updatePC,
+                            i_updateTarget
+);
+    parameter   XLEN            = 32;
+    parameter   BHT_ADDR_WIDTH  = 6; // 64 entry BHT (2-bit counters)
+    parameter   BTB_ADDR_WIDTH  = 4; // 16 entry BTB
+    parameter   PC_LSB          = 2; // Lowest PC bit used for indexing (1 for RV32C)
+    parameter   BHT_RESET       = 0; // 1: Reset the BHT counters (e.g. for repeatable simulation runs - costs FFs)
+    localparam  BHT_DEPTH       = 2**BHT_ADDR_WIDTH;
+    localparam  BTB_DEPTH       = 2**BTB_ADDR_WIDTH;
+    localparam  TAG_WIDTH       = XLEN-BTB_ADDR_WIDTH-PC_LSB;
+
+    // 2-bit saturating counter states
+    localparam  STRONG_NT       = 2'b00;
+    localparam  WEAK_NT         = 2'b01;
+    localparam  STRONG_T        = 2'b11;
+
+    reg         [1:0]           bht         [BHT_DEPTH-1:0] /*verilator public*/;
+    reg                         btbValid    [BTB_DEPTH-1:0] /*verilator public*/;
+    reg                         btbJmp      [BTB_DEPTH-1:0];
+    reg         [TAG_WIDTH-1:0] btbTag      [BTB_DEPTH-1:0];
+    reg         [XLEN-1:0]      btbTarget   [BTB_DEPTH-1:0];
+
+    /* verilator lint_off UNUSED */
+    wire        [XLEN-1:0]      fetchPC     = i_fetchPC;
+    wire        [XLEN-1:0]      updatePC    = i_updatePC;
+    /* verilator lint_on UNUSED */
+    wire [BHT_ADDR_WIDTH-1:0]   fetchBhtIdx = fetchPC[BHT_ADDR_WIDTH+PC_LSB-1:PC_LSB];
+    wire [BTB_ADDR_WIDTH-1:0]   fetchBtbIdx = fetchPC[BTB_ADDR_WIDTH+PC_LSB-1:PC_LSB];
+    wire [BHT_ADDR_WIDTH-1:0]   updBhtIdx   = updatePC[BHT_ADDR_WIDTH+PC_LSB-1:PC_LSB];
+    wire [BTB_ADDR_WIDTH-1:0]   updBtbIdx   = updatePC[BTB_ADDR_WIDTH+PC_LSB-1:PC_LSB];
+    wire                        btbHit      = btbValid[fetchBtbIdx] && (btbTag[fetchBtbIdx] == fetchPC[XLEN-1:BTB_ADDR_WIDTH+PC_LSB]);
+    wire        [1:0]           bhtCounter  = bht[updBhtIdx];
+
+    integer i;
+    initial begin
+        for (i=0; i<BHT_DEPTH; i=i+1) begin
+            bht[i] = WEAK_NT;
+        end
+    end
+
+    // Predict taken on a BTB hit for jumps, or for branches w/ a taken-biased counter
+    assign o_predTaken  = btbHit && (btbJmp[fetchBtbIdx] || bht[fetchBhtIdx][1]);
+    assign o_predTarget = btbTarget[fetchBtbIdx];
+
+    // BHT update (branches only)
+    always @(posedge i_clk) begin
+        if ((BHT_RESET == 1) && i_rst) begin
+            for (i=0; i<BHT_DEPTH; i=i+1) begin
+                bht[i] <= WEAK_NT;
+            end
+        end else if (i_update && i_updateBra) begin
+            if (i_updateTaken) begin
+                bht[updBhtIdx] <= (bhtCounter == STRONG_T)  ? STRONG_T  : bhtCounter + 2'b01;
+            end else begin
+                bht[updBhtIdx] <= (bhtCounter == STRONG_NT) ? STRONG_NT : bhtCounter - 2'b01;
+            end
+        end
+    end
+
+    // BTB update - allocate on taken, drop stale entries that were mispredicted for non-branches
+    always @(posedge i_clk) begin
+        if (i_rst) begin
+            for (i=0; i<BTB_DEPTH; i=i+1) begin
+                btbValid[i] <= 1'b0;
+            end
+        end else if (i_update && i_updateTaken) begin
+            btbValid    [updBtbIdx] <= 1'b1;
+            btbJmp      [updBtbIdx] <= i_updateJmp;
+            btbTag      [updBtbIdx] <= updatePC[XLEN-1:BTB_ADDR_WIDTH+PC_LSB];
+            btbTarget   [updBtbIdx] <= i_updateTarget;
+        end else if (i_update && ~i_updateBra && ~i_updateJmp) begin
+            btbValid    [updBtbIdx] <= 1'b0;
+        end
+    end
+
+endmodule
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+// RV32C expander - maps a 16b compressed instruction onto its 32b RV32I equivalent.
+// Illegal/reserved (and RV64/FP-only) encodings expand to 32'h0 (defined-illegal).
+module CompressedDecoder (
+    input       [15:0]  i_instr,
+    output reg  [31:0]  o_instr
+);
+    // Base opcodes (RV32I)
+    localparam  OP_LOAD     = 7'b0000011;
+    localparam  OP_STORE    = 7'b0100011;
+    localparam  OP_IMM      = 7'b0010011;
+    localparam  OP_OP       = 7'b0110011;
+    localparam  OP_LUI      = 7'b0110111;
+    localparam  OP_BRANCH   = 7'b1100011;
+    localparam  OP_JALR     = 7'b1100111;
+    localparam  OP_JAL      = 7'b1101111;
+    localparam  EBREAK      = 32'h00100073;
+    localparam  ILLEGAL     = 32'h0;
+    localparam  X0          = 5'd0;
+    localparam  RA          = 5'd1;
+    localparam  SP          = 5'd2;
+
+    // Register fields (full and 3-bit "popular" x8-x15 forms)
+    wire    [4:0]   rd      = i_instr[11:7];
+    wire    [4:0]   rs2     = i_instr[6:2];
+    wire    [4:0]   rdP     = {2'b01, i_instr[4:2]};
+    wire    [4:0]   rs1P    = {2'b01, i_instr[9:7]};
+    wire    [4:0]   shamt   = i_instr[6:2];
+    // Immediates (scaled/sign-extended to their RV32I field widths)
+    wire    [11:0]  imm6    = {{7{i_instr[12]}}, i_instr[6:2]};
+    wire    [11:0]  lwImm   = {5'd0, i_instr[5], i_instr[12:10], i_instr[6], 2'b00};
+    wire    [11:0]  lwspImm = {4'd0, i_instr[3:2], i_instr[12], i_instr[6:4], 2'b00};
+    wire    [11:0]  swspImm = {4'd0, i_instr[8:7], i_instr[12:9], 2'b00};
+    wire    [11:0]  a4spImm = {2'd0, i_instr[10:7], i_instr[12:11], i_instr[5], i_instr[6], 2'b00};
+    wire    [11:0]  a16spImm= {{3{i_instr[12]}}, i_instr[4:3], i_instr[5], i_instr[2], i_instr[6], 4'd0};
+    wire    [19:0]  luiImm  = {{15{i_instr[12]}}, i_instr[6:2]};
+    wire    [20:0]  jImm    = {{10{i_instr[12]}}, i_instr[8], i_instr[10:9], i_instr[6], i_instr[7],
+                               i_instr[2], i_instr[11], i_instr[5:3], 1'b0};
+    wire    [12:0]  bImm    = {{5{i_instr[12]}}, i_instr[6:5], i_instr[2], i_instr[11:10], i_instr[4:3], 1'b0};
+    // Expanded control transfer/store encodings
+    wire    [31:0]  cJal    = {jImm[20], jImm[10:1], jImm[11], jImm[19:12], X0, OP_JAL};
+    wire    [31:0]  cBra    = {bImm[12], bImm[10:5], X0, rs1P, 2'b00, i_instr[13], bImm[4:1], bImm[11], OP_BRANCH};
+
+    always @* begin
+        case ({i_instr[15:13], i_instr[1:0]})
+            // Quadrant 0
+            5'b000_00   : o_instr = (a4spImm == 12'd0)  ? ILLEGAL : {a4spImm, SP, 3'b000, rdP, OP_IMM};        // C.ADDI4SPN
+            5'b010_00   : o_instr = {lwImm, rs1P, 3'b010, rdP, OP_LOAD};                                        // C.LW
+            5'b110_00   : o_instr = {lwImm[11:5], rdP, rs1P, 3'b010, lwImm[4:0], OP_STORE};                     // C.SW
+            // Quadrant 1
+            5'b000_01   : o_instr = {imm6, rd, 3'b000, rd, OP_IMM};                                             // C.ADDI/C.NOP
+            5'b001_01   : o_instr = {cJal[31:12], RA, OP_JAL};                                                  // C.JAL
+            5'b010_01   : o_instr = {imm6, X0, 3'b000, rd, OP_IMM};                                             // C.LI
+            5'b011_01   : begin
+                if (rd == SP) begin
+                    o_instr = (a16spImm == 12'd0) ? ILLEGAL : {a16spImm, SP, 3'b000, SP, OP_IMM};           // C.ADDI16SP
+                end else begin
+                    o_instr = (imm6 == 12'd0)     ? ILLEGAL : {luiImm, rd, OP_LUI};                         // C.LUI
+                end
+            end
+            5'b100_01   : begin
+                case (i_instr[11:10])
+                    2'b00   : o_instr = i_instr[12] ? ILLEGAL : {7'b0000000, shamt, rs1P, 3'b101, rs1P, OP_IMM}; // C.SRLI
+                    2'b01   : o_instr = i_instr[12] ? ILLEGAL : {7'b0100000, shamt, rs1P, 3'b101, rs1P, OP_IMM}; // C.SRAI
+                    2'b10   : o_instr = {imm6, rs1P, 3'b111, rs1P, OP_IMM};                                 // C.ANDI
+                    default : begin
+                        case ({i_instr[12], i_instr[6:5]})
+                            3'b0_00 : o_instr = {7'b0100000, rdP, rs1P, 3'b000, rs1P, OP_OP};               // C.SUB
+                            3'b0_01 : o_instr = {7'b0000000, rdP, rs1P, 3'b100, rs1P, OP_OP};               // C.XOR
+                            3'b0_10 : o_instr = {7'b0000000, rdP, rs1P, 3'b110, rs1P, OP_OP};               // C.OR
+                            3'b0_11 : o_instr = {7'b0000000, rdP, rs1P, 3'b111, rs1P, OP_OP};               // C.AND
+                            default : o_instr = ILLEGAL;                                                    // RV64 C.SUBW/C.ADDW
+                        endcase
+                    end
+                endcase
+            end
+            5'b101_01   : o_instr = cJal;                                                                   // C.J
+            5'b110_01,
+            5'b111_01   : o_instr = cBra;                                                                   // C.BEQZ/C.BNEZ
+            // Quadrant 2
+            5'b000_10   : o_instr = i_instr[12] ? ILLEGAL : {7'b0000000, shamt, rd, 3'b001, rd, OP_IMM};    // C.SLLI
+            5'b010_10   : o_instr = (rd == X0)  ? ILLEGAL : {lwspImm, SP, 3'b010, rd, OP_LOAD};             // C.LWSP
+            5'b100_10   : begin
+                if (~i_instr[12]) begin
+                    if (rs2 == X0) begin
+                        o_instr = (rd == X0) ? ILLEGAL : {12'd0, rd, 3'b000, X0, OP_JALR};                  // C.JR
+                    end else begin
+                        o_instr = {7'b0000000, rs2, X0, 3'b000, rd, OP_OP};                                 // C.MV
+                    end
+                end else begin
+                    if (rs2 == X0) begin
+                        o_instr = (rd == X0) ? EBREAK : {12'd0, rd, 3'b000, RA, OP_JALR};                   // C.EBREAK/C.JALR
+                    end else begin
+                        o_instr = {7'b0000000, rs2, rd, 3'b000, rd, OP_OP};                                 // C.ADD
+                    end
+                end
+            end
+            5'b110_10   : o_instr = {swspImm[11:5], rs2, SP, 3'b010, swspImm[4:0], OP_STORE};               // C.SWSP
+            default     : o_instr = ILLEGAL;
+        endcase
+    end
+endmodule
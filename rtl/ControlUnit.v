@@ -8,9 +8,13 @@ module ControlUnit (
     input       [2:0]       i_funct3,
     /* verilator lint_off UNUSED */
     input       [6:0]       i_funct7,
+    input       [4:0]       i_rs2,
     /* verilator lint_on UNUSED */
-    output      [13:0]      o_ctrlSigs
+    output      [14:0]      o_ctrlSigs
 );
+    parameter RV32M     = 0; // 1: Decode RV32M (multiply/divide) instructions
+    parameter ZB_EXT    = 0; // 1: Decode Zba/Zbb (bit-manipulation) instructions
+
     localparam
     //  Format ctrl sigs:  { EXEC_A | EXEC_B | MEM_W  | REG_W  | MEM2REG | BRA     | JMP    }
         R_CTRL          =  { `REG   , `REG   , `FALSE , `TRUE  , `FALSE  , `FALSE  , `FALSE },
@@ -66,12 +70,44 @@ module ControlUnit (
         SRA     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SRA    , R_CTRL        },
         OR      /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_OR     , R_CTRL        },
         AND     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_AND    , R_CTRL        },
+        MUL     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MUL    , R_CTRL        },
+        MULH    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MULH   , R_CTRL        },
+        MULHSU  /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MULHSU , R_CTRL        },
+        MULHU   /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MULHU  , R_CTRL        },
+        DIV     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_DIV    , R_CTRL        },
+        DIVU    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_DIVU   , R_CTRL        },
+        REM     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_REM    , R_CTRL        },
+        REMU    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_REMU   , R_CTRL        },
+        ANDN    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ANDN   , R_CTRL        },
+        ORN     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ORN    , R_CTRL        },
+        XNOR    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_XNOR   , R_CTRL        },
+        MIN     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MIN    , R_CTRL        },
+        MAX     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MAX    , R_CTRL        },
+        MINU    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MINU   , R_CTRL        },
+        MAXU    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_MAXU   , R_CTRL        },
+        ROL     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ROL    , R_CTRL        },
+        ROR     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ROR    , R_CTRL        },
+        ZEXTH   /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ZEXTH  , R_CTRL        },
+        SH1ADD  /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SH1ADD , R_CTRL        },
+        SH2ADD  /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SH2ADD , R_CTRL        },
+        SH3ADD  /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SH3ADD , R_CTRL        },
+        CLZ     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_CLZ    , I_ARITH_CTRL  },
+        CTZ     /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_CTZ    , I_ARITH_CTRL  },
+        CPOP    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_CPOP   , I_ARITH_CTRL  },
+        SEXTB   /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SEXTB  , I_ARITH_CTRL  },
+        SEXTH   /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_SEXTH  , I_ARITH_CTRL  },
+        RORI    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ROR    , I_ARITH_CTRL  },
+        ORCB    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ORCB   , I_ARITH_CTRL  },
+        REV8    /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_REV8   , I_ARITH_CTRL  },
         FENCE   /*verilator public*/=   { `FALSE, `FALSE, `ALU_OP_ADD    , FENCE_CTRL    },
         ECALL   /*verilator public*/=   { `FALSE, `TRUE , `ALU_OP_ADD    , SYSTEM_CTRL   },
         INVALID /*verilator public*/=   { `TRUE , `FALSE, `ALU_OP_ADD    , INVALID_CTRL  };
 
-    reg[13:0] cm_out;
-    reg[13:0] funct_cm_out;
+    reg[14:0] cm_out;
+    reg[14:0] funct_cm_out;
+    reg[14:0] muldiv_cm_out;
+    reg[14:0] zb_cm_out;
+    reg       zb_hit;
 
     // Control Unit decoding
     always @(*) begin
@@ -118,10 +154,53 @@ module ControlUnit (
             3'b111  : funct_cm_out = AND;
             default : funct_cm_out = INVALID;
         endcase
+        // RV32M Control Unit decoding
+        case (i_funct3)
+            3'b000  : muldiv_cm_out = MUL;
+            3'b001  : muldiv_cm_out = MULH;
+            3'b010  : muldiv_cm_out = MULHSU;
+            3'b011  : muldiv_cm_out = MULHU;
+            3'b100  : muldiv_cm_out = DIV;
+            3'b101  : muldiv_cm_out = DIVU;
+            3'b110  : muldiv_cm_out = REM;
+            3'b111  : muldiv_cm_out = REMU;
+            default : muldiv_cm_out = INVALID;
+        endcase
+        // Zba/Zbb Control Unit decoding (overrides the RV32I decode on a hit)
+        zb_hit = 1'b1;
+        casez ({i_opcode, i_funct7, i_funct3, i_rs2})
+            {`OP_MAP_OP,     7'b0100000, 3'b111, 5'b?????} : zb_cm_out = ANDN;
+            {`OP_MAP_OP,     7'b0100000, 3'b110, 5'b?????} : zb_cm_out = ORN;
+            {`OP_MAP_OP,     7'b0100000, 3'b100, 5'b?????} : zb_cm_out = XNOR;
+            {`OP_MAP_OP,     7'b0000101, 3'b100, 5'b?????} : zb_cm_out = MIN;
+            {`OP_MAP_OP,     7'b0000101, 3'b101, 5'b?????} : zb_cm_out = MINU;
+            {`OP_MAP_OP,     7'b0000101, 3'b110, 5'b?????} : zb_cm_out = MAX;
+            {`OP_MAP_OP,     7'b0000101, 3'b111, 5'b?????} : zb_cm_out = MAXU;
+            {`OP_MAP_OP,     7'b0110000, 3'b001, 5'b?????} : zb_cm_out = ROL;
+            {`OP_MAP_OP,     7'b0110000, 3'b101, 5'b?????} : zb_cm_out = ROR;
+            {`OP_MAP_OP,     7'b0000100, 3'b100, 5'b00000} : zb_cm_out = ZEXTH;
+            {`OP_MAP_OP,     7'b0010000, 3'b010, 5'b?????} : zb_cm_out = SH1ADD;
+            {`OP_MAP_OP,     7'b0010000, 3'b100, 5'b?????} : zb_cm_out = SH2ADD;
+            {`OP_MAP_OP,     7'b0010000, 3'b110, 5'b?????} : zb_cm_out = SH3ADD;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b001, 5'b00000} : zb_cm_out = CLZ;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b001, 5'b00001} : zb_cm_out = CTZ;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b001, 5'b00010} : zb_cm_out = CPOP;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b001, 5'b00100} : zb_cm_out = SEXTB;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b001, 5'b00101} : zb_cm_out = SEXTH;
+            {`OP_MAP_OP_IMM, 7'b0110000, 3'b101, 5'b?????} : zb_cm_out = RORI;
+            {`OP_MAP_OP_IMM, 7'b0010100, 3'b101, 5'b00111} : zb_cm_out = ORCB;
+            {`OP_MAP_OP_IMM, 7'b0110100, 3'b101, 5'b11000} : zb_cm_out = REV8;
+            default : begin
+                zb_cm_out   = INVALID;
+                zb_hit      = 1'b0;
+            end
+        endcase
     end
 
     // Output logic
     wire fcm_sel        = i_opcode == `OP_MAP_OP; // (i.e. RV32I R-type)
-    assign o_ctrlSigs   = fcm_sel ? funct_cm_out : cm_out;
+    wire mcm_sel        = (RV32M != 0) && (i_funct7 == `FUNCT7_MULDIV); // (i.e. RV32M R-type)
+    wire zcm_sel        = (ZB_EXT != 0) && zb_hit; // (i.e. Zba/Zbb R-type or OP-IMM)
+    assign o_ctrlSigs   = zcm_sel ? zb_cm_out : fcm_sel ? (mcm_sel ? muldiv_cm_out : funct_cm_out) : cm_out;
 
 endmodule
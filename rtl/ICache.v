@@ -0,0 +1,111 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+module ICache (
+    input                   i_clk,
+                            i_rst,
+    // Core fetch port (0cc hit)
+    input       [XLEN-1:0]  i_addr,
+    output                  o_valid,
+    output      [XLEN-1:0]  o_data,
+    // Memory refill port (req/valid - one word per transfer)
+    output                  o_memReq,
+    output      [XLEN-1:0]  o_memAddr,
+    input                   i_memValid,
+    input       [XLEN-1:0]  i_memData
+);
+    parameter   XLEN            = 32;
+    parameter   WAYS            = 1; // 1: Direct-mapped, 2: 2-way set-associative (LRU)
+    parameter   SET_ADDR_WIDTH  = 4; // log2(sets)
+    parameter   LINE_ADDR_WIDTH = 2; // log2(words per line) - must be >= 1
+    localparam  SETS            = 2**SET_ADDR_WIDTH;
+    localparam  LINE_WORDS      = 2**LINE_ADDR_WIDTH;
+    localparam  OFFSET_WIDTH    = LINE_ADDR_WIDTH+2;
+    localparam  TAG_WIDTH       = XLEN-SET_ADDR_WIDTH-OFFSET_WIDTH;
+    localparam  LINE_IDX_WIDTH  = SET_ADDR_WIDTH+WAYS-1; // {way, set}
+    localparam  LINES           = 2**LINE_IDX_WIDTH;
+
+    reg [XLEN-1:0]                      data    [(LINES*LINE_WORDS)-1:0] /*verilator public*/;
+    reg [TAG_WIDTH-1:0]                 tags    [LINES-1:0];
+    reg                                 valid   [LINES-1:0] /*verilator public*/;
+    reg                                 lru     [SETS-1:0]; // Next way to replace (2-way only)
+
+    // Refill state
+    reg                                 r_busy /*verilator public*/;
+    reg                                 r_way;
+    reg [XLEN-OFFSET_WIDTH-1:0]         r_lineAddr;
+    reg [LINE_ADDR_WIDTH-1:0]           r_word;
+
+    /* verilator lint_off UNUSED */
+    wire [XLEN-1:0]                     addr        = i_addr;
+    /* verilator lint_on UNUSED */
+    wire [LINE_ADDR_WIDTH-1:0]          word        = addr[OFFSET_WIDTH-1:2];
+    wire [SET_ADDR_WIDTH-1:0]           set         = addr[SET_ADDR_WIDTH+OFFSET_WIDTH-1:OFFSET_WIDTH];
+    wire [TAG_WIDTH-1:0]                tag         = addr[XLEN-1:SET_ADDR_WIDTH+OFFSET_WIDTH];
+    wire [SET_ADDR_WIDTH-1:0]           refillSet   = r_lineAddr[SET_ADDR_WIDTH-1:0];
+    wire [LINE_IDX_WIDTH-1:0]           line0, line1, refillLine, victimLine;
+    wire                                hit0, hit1, victimWay;
+
+    // Way 0 (always present)
+    assign line0 = {{(LINE_IDX_WIDTH-SET_ADDR_WIDTH){1'b0}}, set};
+    assign hit0  = valid[line0] && (tags[line0] == tag);
+    // Way 1 (2-way only)
+    generate
+        if (WAYS == 2) begin : gen_WAYS
+            assign line1        = {1'b1, set};
+            assign hit1         = valid[line1] && (tags[line1] == tag);
+            assign victimWay    = ~valid[line0] ? 1'b0 : ~valid[line1] ? 1'b1 : lru[set];
+            assign refillLine   = {r_way, refillSet};
+            assign victimLine   = {victimWay, set};
+        end else begin : gen_WAYS
+            assign line1        = line0;
+            assign hit1         = 1'b0;
+            assign victimWay    = 1'b0;
+            assign refillLine   = refillSet;
+            assign victimLine   = set;
+        end
+    endgenerate
+
+    // Lookup
+    assign o_valid      = hit0 || hit1;
+    assign o_data       = hit1 ? data[{line1, word}] : data[{line0, word}];
+    assign o_memReq     = r_busy;
+    assign o_memAddr    = {r_lineAddr, r_word, 2'b00};
+
+    integer i;
+    always @(posedge i_clk) begin
+        if (i_rst) begin
+            r_busy  <= 1'b0;
+            for (i=0; i<LINES; i=i+1) begin
+                valid[i] <= 1'b0;
+            end
+            for (i=0; i<SETS; i=i+1) begin
+                lru[i] <= 1'b0;
+            end
+        end else if (r_busy) begin
+            // Refill one word per memory transfer, line goes valid on the last word
+            if (i_memValid) begin
+                data[{refillLine, r_word}]  <= i_memData;
+                r_word                      <= r_word + 1'b1;
+                if (&r_word) begin
+                    valid   [refillLine]    <= 1'b1;
+                    tags    [refillLine]    <= r_lineAddr[XLEN-OFFSET_WIDTH-1:SET_ADDR_WIDTH];
+                    r_busy                  <= 1'b0;
+                end
+            end
+        end else if (~o_valid) begin
+            // Miss - start refill of the victim line
+            r_busy                  <= 1'b1;
+            r_way                   <= victimWay;
+            r_lineAddr              <= addr[XLEN-1:OFFSET_WIDTH];
+            r_word                  <= {LINE_ADDR_WIDTH{1'b0}};
+            valid   [victimLine]    <= 1'b0;
+        end else begin
+            // Hit - other way becomes the LRU
+            lru     [set]           <= ~hit1;
+        end
+    end
+
+endmodule
@@ -0,0 +1,124 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+module MulDiv (
+    input                   i_clk,
+                            i_rst,
+                            i_valid,    // RV32M op is in EXEC
+                            i_flush,    // Abort any in-flight op (EXEC flush)
+                            i_hold,     // Rest of pipeline is stalled (hold result)
+    input       [2:0]       i_op,       // RV32M funct3
+    input       [XLEN-1:0]  i_a,
+                            i_b,
+    output reg  [XLEN-1:0]  o_result,
+    output                  o_stall
+);
+    parameter   XLEN        = 32;
+    parameter   MUL_IMPL    = 0; // 0: Single-cycle (DSP), 1: Registered (DSP w/ input/output regs - 2cc stall, no overlap)
+    parameter   DIV_IMPL    = 0; // 0: Iterative radix-2 (1 bit/cc), 1: Iterative radix-4 (2 bits/cc)
+    localparam  DIV_STEPS   = (DIV_IMPL == 1) ? XLEN/2 : XLEN;
+    localparam  CNT_WIDTH   = $clog2(XLEN+1);
+
+    // FSM states
+    localparam  S_IDLE      = 2'd0;
+    localparam  S_MUL       = 2'd1;
+    localparam  S_DIV       = 2'd2;
+    localparam  S_DONE      = 2'd3;
+
+    reg             [1:0]           r_state /*verilator public*/;
+    reg             [CNT_WIDTH-1:0] r_count;
+    reg             [2:0]           r_op;
+    reg             [XLEN-1:0]      r_a, r_b, r_quot, r_rem, r_mulOut;
+    reg                             r_negQ, r_negR, r_divByZero;
+
+    // Operand decoding
+    wire            isDiv           = i_op[2];
+    wire            aSigned         = i_op[1:0] != 2'b11;                   // MULH, MULHSU (MUL is don't care)
+    wire            bSigned         = i_op[1:0] == 2'b01;                   // MULH
+    wire            divSigned       = ~i_op[0];                             // DIV, REM
+    wire            aNeg            = divSigned && i_a[XLEN-1];
+    wire            bNeg            = divSigned && i_b[XLEN-1];
+    wire            needsCycles     = isDiv || (MUL_IMPL == 1);
+
+    // Multiplier (sign-extend to XLEN+1 bits to cover all signed/unsigned combos)
+    wire signed     [XLEN:0]        mulA        = {aSigned && i_a[XLEN-1], i_a};
+    wire signed     [XLEN:0]        mulB        = {bSigned && i_b[XLEN-1], i_b};
+    /* verilator lint_off UNUSED */
+    wire signed     [2*XLEN+1:0]    mulProduct  = MUL_IMPL == 1 ? $signed({r_a[XLEN-1] && r_op[1:0] != 2'b11, r_a}) *
+                                                                  $signed({r_b[XLEN-1] && r_op[1:0] == 2'b01, r_b}) :
+                                                                  mulA * mulB;
+    /* verilator lint_on UNUSED */
+    wire            [2:0]           mulOp       = MUL_IMPL == 1 ? r_op : i_op;
+    wire            [XLEN-1:0]      mulResult   = mulOp[1:0] == 2'b00 ? mulProduct[XLEN-1:0] : mulProduct[2*XLEN-1:XLEN];
+
+    // Divider fixup (sign and divide-by-zero handling)
+    wire            [XLEN-1:0]      quotFixed   = r_divByZero   ? {XLEN{1'b1}}  : r_negQ ? -r_quot : r_quot;
+    wire            [XLEN-1:0]      remFixed    = r_divByZero   ? r_a           : r_negR ? -r_rem  : r_rem;
+
+    // Single restoring division step: shift in next dividend bit, subtract divisor if it fits
+    function [2*XLEN-1:0] divStep; // {rem, quot}
+        input [XLEN-1:0] rem, quot, divisor;
+        reg   [XLEN:0]   trial;
+        begin
+            trial   = {rem, quot[XLEN-1]} - {1'b0, divisor};
+            divStep = trial[XLEN]   ? {rem[XLEN-2:0], quot[XLEN-1], quot[XLEN-2:0], 1'b0}
+                                    : {trial[XLEN-1:0],             quot[XLEN-2:0], 1'b1};
+        end
+    endfunction
+    wire            [2*XLEN-1:0]    divStep1    = divStep(r_rem, r_quot, r_b);
+    wire            [2*XLEN-1:0]    divStep2    = divStep(divStep1[2*XLEN-1:XLEN], divStep1[XLEN-1:0], r_b);
+    wire            [2*XLEN-1:0]    divNext     = DIV_IMPL == 1 ? divStep2 : divStep1;
+
+    always @(posedge i_clk) begin
+        if (i_rst || i_flush) begin
+            r_state <= S_IDLE;
+        end else begin
+            case (r_state)
+                S_IDLE  : begin
+                    // Latch operands on start (forwarded values may change while stalled)
+                    if (i_valid && needsCycles && ~i_hold) begin
+                        r_state     <= isDiv ? S_DIV : S_MUL;
+                        r_op        <= i_op;
+                        r_count     <= DIV_STEPS[CNT_WIDTH-1:0];
+                        r_negQ      <= aNeg ^ bNeg;
+                        r_negR      <= aNeg;
+                        r_divByZero <= ~|i_b;
+                        r_quot      <= aNeg ? -i_a : i_a;
+                        r_rem       <= {XLEN{1'b0}};
+                        r_a         <= i_a;
+                        r_b         <= isDiv ? (bNeg ? -i_b : i_b) : i_b;
+                    end
+                end
+                S_MUL   : begin
+                    r_mulOut        <= mulResult;
+                    r_state         <= S_DONE;
+                end
+                S_DIV   : begin
+                    r_rem           <= divNext[2*XLEN-1:XLEN];
+                    r_quot          <= divNext[XLEN-1:0];
+                    r_count         <= r_count - 1'b1;
+                    r_state         <= (r_count == 1) ? S_DONE : S_DIV;
+                end
+                S_DONE  : begin
+                    // Hold result until the op leaves EXEC
+                    r_state         <= i_hold ? S_DONE : S_IDLE;
+                end
+            endcase
+        end
+    end
+
+    // Result select
+    always @(*) begin
+        if (~needsCycles) begin
+            o_result = mulResult;
+        end else if (r_op[2]) begin
+            o_result = r_op[1] ? remFixed : quotFixed;
+        end else begin
+            o_result = r_mulOut;
+        end
+    end
+    assign o_stall = i_valid && needsCycles && (r_state != S_DONE);
+
+endmodule
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+`include "types.vh"
+
+module WishboneBridge (
+    input                   i_clk,
+                            i_rst,
+    // Core port (req/valid)
+    input                   i_req,
+                            i_we,
+    input       [XLEN-1:0]  i_addr,
+                            i_data,
+    input       [3:0]       i_byteEn,
+    output                  o_valid,
+    output      [XLEN-1:0]  o_data,
+    // Wishbone B4 (classic) master port
+    output                  o_wb_cyc,
+                            o_wb_stb,
+                            o_wb_we,
+    output      [XLEN-1:0]  o_wb_adr,
+                            o_wb_dat,
+    output      [3:0]       o_wb_sel,
+    input       [XLEN-1:0]  i_wb_dat,
+    input                   i_wb_ack
+);
+    parameter   XLEN    = 32;
+
+    reg                 r_busy /*verilator public*/;
+    reg                 r_we;
+    reg [XLEN-1:0]      r_addr, r_data;
+    reg [3:0]           r_sel;
+
+    // Bus signals are registered and held until ack (addr/data may change on the core side)
+    always @(posedge i_clk) begin
+        if (i_rst) begin
+            r_busy  <= 1'b0;
+        end else if (~r_busy && i_req) begin
+            r_busy  <= 1'b1;
+            r_we    <= i_we;
+            r_addr  <= i_addr;
+            r_data  <= i_data;
+            r_sel   <= i_we ? i_byteEn : 4'b1111;
+        end else if (r_busy && i_wb_ack) begin
+            r_busy  <= 1'b0;
+        end
+    end
+
+    assign o_wb_cyc = r_busy;
+    assign o_wb_stb = r_busy;
+    assign o_wb_we  = r_we;
+    assign o_wb_adr = r_addr;
+    assign o_wb_dat = r_data;
+    assign o_wb_sel = r_sel;
+
+    // Drop acks for a request the core no longer wants (e.g. fetch redirected)
+    assign o_valid  = r_busy && i_wb_ack && i_req && (i_addr == r_addr);
+    assign o_data   = i_wb_dat;
+
+endmodule
@@ -8,14 +8,26 @@ module flintRV (
     input   [INSTR_WIDTH-1:0]   i_instr,
     input          [XLEN-1:0]   i_dataIn,
     output                      o_storeReq, o_loadReq,
-    output         [XLEN-1:0]   o_pcOut, o_dataAddr, o_dataOut
+    output         [XLEN-1:0]   o_pcOut, o_dataAddr, o_dataOut,
+    output                [3:0] o_byteEn
 );
     // CPU configs
     parameter XLEN                  = 32;
     parameter PC_START              = 0;
-    parameter INSTR_WIDTH           = 32; // 16 for RV32C (otherwise 32)
+    parameter INSTR_WIDTH           = 32; // Fetch window (RV32C: 32b read at 16b-aligned PCs)
     parameter ICACHE_LATENCY        = 0;  // 0 cc: LUT cache, 1 cc: BRAM cache
     parameter REGFILE_ADDR_WIDTH    = 5;  // 4 for RV32E (otherwise 5)
+    parameter RV32M                 = 0;  // 1: Enable RV32M multiply/divide unit
+    parameter MUL_IMPL              = 0;  // 0: Single-cycle (DSP), 1: Registered (2cc stall)
+    parameter DIV_IMPL              = 0;  // 0: Iterative radix-2, 1: Iterative radix-4
+    parameter BRANCH_PREDICTOR      = 0;  // 0: Static not-taken, 1: Dynamic (2-bit BHT + BTB)
+    parameter BHT_ADDR_WIDTH        = 6;  // log2(BHT entries)
+    parameter BTB_ADDR_WIDTH        = 4;  // log2(BTB entries)
+    parameter BHT_RESET             = 0;  // 1: Reset the BHT on i_rst (deterministic reruns in simulation)
+    parameter EARLY_BRANCH          = 0;  // 0: Resolve branches/jumps in MEM, 1: Resolve in EXEC
+    parameter LOAD_FWD              = 0;  // 1: Forward load data from MEM into EXEC (no load-use bubble)
+    parameter RV32C                 = 0;  // 1: Enable RV32C compressed instruction expander
+    parameter ZB_EXT                = 0;  // 1: Enable Zba/Zbb bit-manipulation ops
 
     // Helper Aliases
     localparam REG_0    /*verilator public*/ = 5'b00000; // Register x0
@@ -47,7 +59,7 @@ module flintRV (
     reg      [4:0]  p_rs1Addr   [EXEC:WB]/*verilator public*/;
     reg      [4:0]  p_rs2Addr   [EXEC:WB]/*verilator public*/;
     reg      [4:0]  p_rdAddr    [EXEC:WB]/*verilator public*/;
-    reg      [4:0]  p_aluOp     [EXEC:WB]/*verilator public*/;
+    reg      [5:0]  p_aluOp     [EXEC:WB]/*verilator public*/;
     reg      [2:0]  p_funct3    [EXEC:WB]/*verilator public*/;
     reg             p_mem_w     [EXEC:WB]/*verilator public*/;
     reg             p_reg_w     [EXEC:WB]/*verilator public*/;
@@ -59,23 +71,68 @@ module flintRV (
     reg             p_ebreak    [EXEC:WB]/*verilator public*/;
     reg             p_ecall     [EXEC:WB]/*verilator public*/;
     reg             p_jalr      [EXEC:WB]/*verilator public*/;
+    reg             p_predTaken [EXEC:WB]/*verilator public*/;
+    reg [XLEN-1:0]  p_predTarget[EXEC:WB]/*verilator public*/;
+    reg             p_isC       [EXEC:WB]/*verilator public*/;
+    reg             p_valid     [EXEC:WB]/*verilator public*/; // Not a bubble (i.e. retires at WB)
 
     // Internal regs
-    reg  [XLEN-1:0] PC, PCReg, instrReg, loadData, storeData;
+    reg  [XLEN-1:0] PC, PCReg /*verilator public*/, instrReg, loadData, storeData, predTargetReg;
+    reg       [3:0] byteEn;
+    reg             predTakenReg, isCReg, validReg /*verilator public*/;
+    // Reset vector (Verilated models can move it to restart at a handed-off PC - synthesis always uses PC_START)
+`ifdef VERILATOR
+    reg  [XLEN-1:0] startPC /*verilator public*/;
+    initial startPC = PC_START;
+`else
+    wire [XLEN-1:0] startPC = PC_START;
+`endif // VERILATOR
     // Internal wires
     wire [XLEN-1:0] IMM, aluOut, jumpAddr, rs1Out, rs2Out, rs1Exec, rs2Exec, WB_result, 
-                    aluSrcA, aluSrcB, ctrlTransSrcA, jmpResult;
-    wire     [13:0] ctrlSigs;
-    wire      [4:0] aluOp;
+                    aluSrcA, aluSrcB, ctrlTransSrcA, MEM_result, loadWord, jmpResult, mulDivOut, execResult,
+                    pcJumpAddr, predTarget, resPC, resTarget, resPredTarget, fetchInstr, pcNext;
+    wire     [14:0] ctrlSigs;
+    wire      [5:0] aluOp;
     wire            exec_a, exec_b, mem_w, reg_w, mem2reg, bra, jmp, braOutcome, writeRd, 
                     pcJump /*verilator public*/, RS1_fwd_mem, RS1_fwd_wb, RS2_fwd_mem, 
-                    RS2_fwd_wb, rdFwdRs1En, rdFwdRs2En, load_hazard, load_wait, FETCH_stall, 
-                    EXEC_stall, MEM_stall, FETCH_flush, EXEC_flush, MEM_flush, WB_flush, 
-                    ecall, ebreak, jalr;
+                    RS2_fwd_wb, rdFwdRs1En, rdFwdRs2En, load_wait /*verilator public*/,
+                    store_wait /*verilator public*/, FETCH_stall /*verilator public*/,
+                    MEM_stall /*verilator public*/, load_hazard /*verilator public*/, loadUse /*verilator public*/,
+                    EXEC_stall /*verilator public*/, FETCH_flush, EXEC_flush, MEM_flush /*verilator public*/, WB_flush, 
+                    ecall, ebreak, jalr, isMulDivOp, MULDIV_stall /*verilator public*/, predTaken, ctrlTaken,
+                    mispredict /*verilator public*/, ctrlResolve /*verilator public*/,
+                    resValid, resBra, resJmp, resCmp, resPredTaken, resIsC, fetchIsC, cLink;
 
-    // Branch/jump logic
-    assign pcJump       = braOutcome || p_jmp[MEM];
-    assign braOutcome   = p_bra[MEM] && p_aluOut[MEM][0]; // [Static predictor]: Assume branch not-taken
+    // Branch/jump logic (resolved against the fetch-time prediction)
+    generate
+        if (EARLY_BRANCH == 1) begin : gen_EARLY_BRANCH // Resolve in EXEC (1cc redirect penalty)
+            assign resValid         = ~EXEC_stall;
+            assign resBra           = p_bra         [EXEC];
+            assign resJmp           = p_jmp         [EXEC];
+            assign resCmp           = aluOut        [0];
+            assign resPredTaken     = p_predTaken   [EXEC];
+            assign resPredTarget    = p_predTarget  [EXEC];
+            assign resPC            = p_PC          [EXEC];
+            assign resIsC           = p_isC         [EXEC];
+            assign resTarget        = jumpAddr;
+        end else begin : gen_EARLY_BRANCH // Resolve in MEM (2cc redirect penalty)
+            assign resValid         = 1'b1;
+            assign resBra           = p_bra         [MEM];
+            assign resJmp           = p_jmp         [MEM];
+            assign resCmp           = p_aluOut      [MEM][0];
+            assign resPredTaken     = p_predTaken   [MEM];
+            assign resPredTarget    = p_predTarget  [MEM];
+            assign resPC            = p_PC          [MEM];
+            assign resIsC           = p_isC         [MEM];
+            assign resTarget        = p_jumpAddr    [MEM];
+        end
+    endgenerate
+    assign braOutcome   = resBra && resCmp;
+    assign ctrlTaken    = braOutcome || resJmp;
+    assign ctrlResolve  = resValid && (resBra || resJmp);
+    assign mispredict   = resValid && (ctrlTaken ? (~resPredTaken || (resPredTarget != resTarget)) : resPredTaken);
+    assign pcJump       = mispredict;
+    assign pcJumpAddr   = ctrlTaken ? resTarget : resPC + (resIsC ? 32'd2 : 32'd4);
 
     // Writeback select and enable logic
     assign WB_result    = p_mem2reg[WB] ? p_readData[WB] : p_aluOut[WB];
@@ -86,30 +143,33 @@ module flintRV (
     assign RS1_fwd_wb   = ~RS1_fwd_mem && p_reg_w[WB] && (p_rs1Addr[EXEC] == p_rdAddr[WB]);
     assign RS2_fwd_mem  = p_reg_w[MEM] && (p_rs2Addr[EXEC] == p_rdAddr[MEM]);
     assign RS2_fwd_wb   = ~RS2_fwd_mem && p_reg_w[WB] && (p_rs2Addr[EXEC] == p_rdAddr[WB]);
+    assign MEM_result   = (LOAD_FWD == 1) && p_mem2reg[MEM] ? loadData : p_aluOut[MEM];
     assign rs1Exec      = RS1_fwd_wb    ?   WB_result       :
-                          RS1_fwd_mem   ?   p_aluOut[MEM]   :
+                          RS1_fwd_mem   ?   MEM_result      :
                                             p_rs1[EXEC]     ;
     assign rs2Exec      = RS2_fwd_wb    ?   WB_result       :
-                          RS2_fwd_mem   ?   p_aluOut[MEM]   :
+                          RS2_fwd_mem   ?   MEM_result      :
                                             p_rs2[EXEC]     ;
     assign rdFwdRs1En   = p_reg_w[WB] && (`RS1(instrReg) == p_rdAddr[WB]); // Bogus read if true, fwd RD[WB]
     assign rdFwdRs2En   = p_reg_w[WB] && (`RS2(instrReg) == p_rdAddr[WB]); // Bogus read if true, fwd RD[WB]
 
     // Stall and flush logic
-    assign load_hazard  = p_mem2reg[EXEC] && ((`RS1(instrReg) == p_rdAddr[EXEC]) || (`RS2(instrReg) == p_rdAddr[EXEC]));
+    assign loadUse      = p_mem2reg[EXEC] && ((`RS1(instrReg) == p_rdAddr[EXEC]) || (`RS2(instrReg) == p_rdAddr[EXEC]));
+    assign load_hazard  = (LOAD_FWD == 0) && loadUse; // Otherwise load data is forwarded from MEM
     assign load_wait    = o_loadReq && ~i_memValid;
+    assign store_wait   = o_storeReq && ~i_memValid;
     assign FETCH_stall  = ~i_ifValid || EXEC_stall || MEM_stall || load_hazard;
-    assign EXEC_stall   = MEM_stall;
-    assign MEM_stall    = load_wait;
-    assign FETCH_flush  = i_rst || ~i_ifValid || braOutcome || p_jmp[MEM];
-    assign EXEC_flush   = i_rst || braOutcome || p_jmp[MEM] || load_hazard /* bubble */;
-    assign MEM_flush    = i_rst || braOutcome || p_jmp[MEM];
-    assign WB_flush     = i_rst || load_wait /* bubble */;
+    assign EXEC_stall   = MEM_stall || MULDIV_stall;
+    assign MEM_stall    = load_wait || store_wait;
+    assign FETCH_flush  = i_rst || pcJump || (~i_ifValid && ~(EXEC_stall || load_hazard)) /* bubble */;
+    assign EXEC_flush   = i_rst || pcJump || load_hazard /* bubble */;
+    assign MEM_flush    = i_rst || (pcJump && EARLY_BRANCH == 0) || (MULDIV_stall && ~MEM_stall) /* bubble */;
+    assign WB_flush     = i_rst || MEM_stall /* bubble */;
 
     // Pipeline CTRL reg assignments
     always @(posedge i_clk) begin
         // Execute
-        p_aluOp     [EXEC]  <= EXEC_flush ? 5'd0 : EXEC_stall ? p_aluOp     [EXEC] : aluOp;
+        p_aluOp     [EXEC]  <= EXEC_flush ? 6'd0 : EXEC_stall ? p_aluOp     [EXEC] : aluOp;
         p_mem_w     [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_mem_w     [EXEC] : mem_w;
         p_reg_w     [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_reg_w     [EXEC] : writeRd;
         p_mem2reg   [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_mem2reg   [EXEC] : mem2reg;
@@ -120,6 +180,9 @@ module flintRV (
         p_ebreak    [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_ebreak    [EXEC] : ebreak;
         p_ecall     [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_ecall     [EXEC] : ecall;
         p_jalr      [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_jalr      [EXEC] : jalr;
+        p_predTaken [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_predTaken [EXEC] : predTakenReg;
+        p_isC       [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_isC       [EXEC] : isCReg;
+        p_valid     [EXEC]  <= EXEC_flush ? 1'd0 : EXEC_stall ? p_valid     [EXEC] : validReg;
         // Memory
         p_ecall     [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_ecall   [MEM] : p_ecall     [EXEC];
         p_mem_w     [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_mem_w   [MEM] : p_mem_w     [EXEC];
@@ -127,10 +190,14 @@ module flintRV (
         p_mem2reg   [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_mem2reg [MEM] : p_mem2reg   [EXEC];
         p_bra       [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_bra     [MEM] : p_bra       [EXEC];
         p_jmp       [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_jmp     [MEM] : p_jmp       [EXEC];
+        p_predTaken [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_predTaken[MEM]: p_predTaken [EXEC];
+        p_isC       [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_isC     [MEM] : p_isC       [EXEC];
+        p_valid     [MEM]   <= MEM_flush ? 1'd0 : MEM_stall ? p_valid   [MEM] : p_valid     [EXEC];
         // Writeback
         p_ecall     [WB]    <= WB_flush ? 1'd0 : p_ecall    [MEM];
         p_reg_w     [WB]    <= WB_flush ? 1'd0 : p_reg_w    [MEM];
         p_mem2reg   [WB]    <= WB_flush ? 1'd0 : p_mem2reg  [MEM];
+        p_valid     [WB]    <= WB_flush ? 1'd0 : p_valid    [MEM];
     end
 
     // Pipeline DATA reg assignments
@@ -145,14 +212,18 @@ module flintRV (
         p_rs1Addr   [EXEC]  <= EXEC_stall ? p_rs1Addr   [EXEC] : `RS1(instrReg);
         p_rs2Addr   [EXEC]  <= EXEC_stall ? p_rs2Addr   [EXEC] : `RS2(instrReg);
         p_rdAddr    [EXEC]  <= EXEC_stall ? p_rdAddr    [EXEC] : `RD(instrReg);
+        p_predTarget[EXEC]  <= EXEC_stall ? p_predTarget[EXEC] : predTargetReg;
         // Memory
         p_rs2       [MEM]   <= MEM_stall  ? p_rs2       [MEM] : rs2Exec;
         p_rdAddr    [MEM]   <= MEM_stall  ? p_rdAddr    [MEM] : p_rdAddr  [EXEC];
         p_funct3    [MEM]   <= MEM_stall  ? p_funct3    [MEM] : p_funct3  [EXEC];
-        p_aluOut    [MEM]   <= MEM_stall  ? p_aluOut    [MEM] : aluOut;
+        p_aluOut    [MEM]   <= MEM_stall  ? p_aluOut    [MEM] : execResult;
         p_jumpAddr  [MEM]   <= MEM_stall  ? p_jumpAddr  [MEM] : jumpAddr;
+        p_PC        [MEM]   <= MEM_stall  ? p_PC        [MEM] : p_PC      [EXEC];
+        p_predTarget[MEM]   <= MEM_stall  ? p_predTarget[MEM] : p_predTarget[EXEC];
         // Writeback
         p_aluOut    [WB]    <= p_aluOut [MEM];
+        p_PC        [WB]    <= p_PC     [MEM];
         p_rdAddr    [WB]    <= p_rdAddr [MEM];
         p_funct3    [WB]    <= p_funct3 [MEM];
         p_readData  [WB]    <= loadData;
@@ -160,15 +231,58 @@ module flintRV (
 
     // --- [Stage]: Fetch/Decode ---
     always @(posedge i_clk) begin
-        PC          <=  i_rst       ?   PC_START        :
-                        pcJump      ?   p_jumpAddr[MEM] :
+        PC          <=  i_rst       ?   startPC         :
+                        pcJump      ?   pcJumpAddr      :
                         FETCH_stall ?   PC              :
-                                        PC + 32'd4      ;
+                        predTaken   ?   predTarget      :
+                                        pcNext          ;
     end
+    generate
+        if (RV32C == 1) begin : gen_RV32C // Expand compressed instructions at fetch
+            wire [31:0] expandedInstr;
+            CompressedDecoder RVC_unit (
+                .i_instr    (i_instr[15:0]),
+                .o_instr    (expandedInstr)
+            );
+            assign fetchIsC     = i_instr[1:0] != 2'b11;
+            assign fetchInstr   = fetchIsC ? expandedInstr : i_instr;
+            assign pcNext       = PC + (fetchIsC ? 32'd2 : 32'd4);
+        end else begin : gen_RV32C
+            assign fetchIsC     = 1'b0;
+            assign fetchInstr   = i_instr;
+            assign pcNext       = PC + 32'd4;
+        end
+    endgenerate
+    generate
+        if (BRANCH_PREDICTOR == 1) begin : gen_BRANCH_PREDICTOR
+            BranchPredictor #(
+                .XLEN           (XLEN),
+                .PC_LSB         (RV32C == 1 ? 1 : 2),
+                .BHT_ADDR_WIDTH (BHT_ADDR_WIDTH),
+                .BTB_ADDR_WIDTH (BTB_ADDR_WIDTH),
+                .BHT_RESET      (BHT_RESET)
+            ) BP_unit (
+                .i_clk          (i_clk),
+                .i_rst          (i_rst),
+                .i_fetchPC      (PC),
+                .o_predTaken    (predTaken),
+                .o_predTarget   (predTarget),
+                .i_update       (ctrlResolve || (resValid && resPredTaken)),
+                .i_updateBra    (resBra),
+                .i_updateJmp    (resJmp),
+                .i_updateTaken  (ctrlTaken),
+                .i_updatePC     (resPC),
+                .i_updateTarget (resTarget)
+            );
+        end else begin : gen_BRANCH_PREDICTOR // Static predictor: Assume not-taken
+            assign predTaken    = 1'b0;
+            assign predTarget   = {XLEN{1'b0}};
+        end
+    endgenerate
     generate
         if (ICACHE_LATENCY == 1) begin : gen_ICACHE_LATENCY // BRAM-based I$
-            reg [XLEN-1:0]  PC2;
-            reg             FETCH_flush2;
+            reg [XLEN-1:0]  PC2, predTarget2;
+            reg             FETCH_flush2, predTaken2;
             wire            FETCH_flush_line;
             assign          FETCH_flush_line = FETCH_flush || FETCH_flush2;
             always @(posedge i_clk) begin
@@ -178,6 +292,11 @@ module flintRV (
                 PC2             <=  i_rst               ?   0           :
                                     FETCH_stall         ?   PC2         :
                                                             PC          ;
+                predTaken2      <=  i_rst               ?   0           :
+                                    FETCH_stall         ?   predTaken2  :
+                                                            predTaken   ;
+                predTarget2     <=  FETCH_stall         ?   predTarget2 :
+                                                            predTarget  ;
                 // Buffer instruction fetch to balance the 1cc BRAM-based regfile read
                 instrReg        <=  FETCH_flush_line    ?   NOP         :
                                     FETCH_stall         ?   instrReg    :
@@ -186,17 +305,43 @@ module flintRV (
                 PCReg           <=  FETCH_flush_line    ?   0           :
                                     FETCH_stall         ?   PCReg       :
                                                             PC2         ;
+                // Carry fetch-time prediction alongside the instruction
+                predTakenReg    <=  FETCH_flush_line    ?   0           :
+                                    FETCH_stall         ?   predTakenReg:
+                                                            predTaken2  ;
+                predTargetReg   <=  FETCH_stall         ?   predTargetReg :
+                                                            predTarget2 ;
+                // Flushed fetches are bubbles (i.e. never retire)
+                validReg        <=  FETCH_flush_line    ?   0           :
+                                    FETCH_stall         ?   validReg    :
+                                                            1           ;
+                // RV32C needs a 0cc fetch (next PC depends on the fetched instruction size)
+                isCReg          <=  1'b0;
             end
         end else begin : gen_ICACHE_LATENCY // LUT-based I$
             always @(posedge i_clk) begin
                 // Buffer instruction fetch to balance the 1cc BRAM-based regfile read
                 instrReg    <=  FETCH_flush ?   NOP         :
                                 FETCH_stall ?   instrReg    :
-                                                i_instr     ;
+                                                fetchInstr  ;
                 // Buffer PC reg to balance the 1cc BRAM-based regfile read
                 PCReg       <=  FETCH_flush ?   0           :
                                 FETCH_stall ?   PCReg       :
                                                 PC          ;
+                // Carry fetch-time prediction alongside the instruction
+                predTakenReg    <=  FETCH_flush ?   0               :
+                                    FETCH_stall ?   predTakenReg    :
+                                                    predTaken       ;
+                predTargetReg   <=  FETCH_stall ?   predTargetReg   :
+                                                    predTarget      ;
+                // Carry instruction size (for link/fall-through address)
+                isCReg          <=  FETCH_flush ?   0               :
+                                    FETCH_stall ?   isCReg          :
+                                                    fetchIsC        ;
+                // Flushed fetches are bubbles (i.e. never retire)
+                validReg        <=  FETCH_flush ?   0               :
+                                    FETCH_stall ?   validReg        :
+                                                    1               ;
             end
         end
     endgenerate
@@ -210,17 +355,21 @@ module flintRV (
     ) REGFILE_unit (
         .i_clk      (i_clk),
         .i_wrEn     (p_reg_w[WB]),
-        .i_rs1Addr  (FETCH_stall ? `RS1(instrReg) : `RS1(i_instr)),
-        .i_rs2Addr  (FETCH_stall ? `RS2(instrReg) : `RS2(i_instr)),
+        .i_rs1Addr  (FETCH_stall ? `RS1(instrReg) : `RS1(fetchInstr)),
+        .i_rs2Addr  (FETCH_stall ? `RS2(instrReg) : `RS2(fetchInstr)),
         .i_rdAddr   (p_rdAddr[WB]),
         .i_rdData   (WB_result),
         .o_rs1Data  (rs1Out),
         .o_rs2Data  (rs2Out)
     );
-    ControlUnit CTRL_unit (
+    ControlUnit #(
+        .RV32M      (RV32M),
+        .ZB_EXT     (ZB_EXT)
+    ) CTRL_unit (
         .i_opcode   (`OPCODE_RV32(instrReg)),
         .i_funct3   (`FUNCT3(instrReg)),
         .i_funct7   (`FUNCT7(instrReg)),
+        .i_rs2      (`RS2(instrReg)),
         .o_ctrlSigs (ctrlSigs)
     );
     // Control signals
@@ -240,38 +389,83 @@ module flintRV (
     // ALU
     assign aluSrcA  = (p_exec_a[EXEC] == `PC)   ? p_PC[EXEC]  : rs1Exec;
     assign aluSrcB  = (p_exec_b[EXEC] == `IMM)  ? p_IMM[EXEC] : rs2Exec;
-    ALU #(.XLEN(XLEN)) alu_unit (
+    ALU #(
+        .XLEN     (XLEN),
+        .ZB_EXT   (ZB_EXT)
+    ) alu_unit (
         .i_a      (aluSrcA),
         .i_b      (aluSrcB),
         .i_op     (p_aluOp[EXEC]),
         .o_result (aluOut)
     );
+    // Multiply/divide unit
+    generate
+        if (RV32M == 1) begin : gen_RV32M
+            assign isMulDivOp = p_aluOp[EXEC][5:3] == 3'b010;
+            MulDiv #(
+                .XLEN       (XLEN),
+                .MUL_IMPL   (MUL_IMPL),
+                .DIV_IMPL   (DIV_IMPL)
+            ) MULDIV_unit (
+                .i_clk      (i_clk),
+                .i_rst      (i_rst),
+                .i_valid    (isMulDivOp),
+                .i_flush    (EXEC_flush),
+                .i_hold     (MEM_stall),
+                .i_op       (p_aluOp[EXEC][2:0]),
+                .i_a        (rs1Exec),
+                .i_b        (rs2Exec),
+                .o_result   (mulDivOut),
+                .o_stall    (MULDIV_stall)
+            );
+        end else begin : gen_RV32M
+            assign isMulDivOp   = 1'b0;
+            assign mulDivOut    = {XLEN{1'b0}};
+            assign MULDIV_stall = 1'b0;
+        end
+    endgenerate
+    // Compressed jumps link to PC+2 (ALU_OP_ADD4A assumes a 32b instruction)
+    assign cLink            = p_isC[EXEC] && p_jmp[EXEC];
+    assign execResult       = isMulDivOp ? mulDivOut : cLink ? p_PC[EXEC] + 32'd2 : aluOut;
     // Generate jump address
     assign ctrlTransSrcA    = p_jalr[EXEC] ? rs1Exec : p_PC[EXEC];
     assign jmpResult        = ctrlTransSrcA + p_IMM[EXEC];
     assign jumpAddr         = p_jalr[EXEC] ? {jmpResult[XLEN-1:1],1'b0} : jmpResult;
 
     // --- [Stage]: Memory ---
+    // Stores are lane-shifted by the byte offset, with byte enables for strobed (word-aligned) memories
     always @(*) begin
         case (p_funct3[MEM])
-            S_B_OP  : storeData = {24'd0, p_rs2[MEM][7:0]};
-            S_H_OP  : storeData = {16'd0, p_rs2[MEM][15:0]};
+            S_B_OP  : storeData = {24'd0, p_rs2[MEM][7:0]}  << {p_aluOut[MEM][1:0], 3'd0};
+            S_H_OP  : storeData = {16'd0, p_rs2[MEM][15:0]} << {p_aluOut[MEM][1], 4'd0};
             S_W_OP  : storeData = p_rs2[MEM];
-            S_BU_OP : storeData = {24'd0, p_rs2[MEM][7:0]};
-            S_HU_OP : storeData = {16'd0, p_rs2[MEM][15:0]};
+            S_BU_OP : storeData = {24'd0, p_rs2[MEM][7:0]}  << {p_aluOut[MEM][1:0], 3'd0};
+            S_HU_OP : storeData = {16'd0, p_rs2[MEM][15:0]} << {p_aluOut[MEM][1], 4'd0};
             default : storeData = p_rs2[MEM];
         endcase
     end
+    always @(*) begin
+        case (p_funct3[MEM])
+            S_B_OP  : byteEn = 4'b0001 << p_aluOut[MEM][1:0];
+            S_H_OP  : byteEn = 4'b0011 << {p_aluOut[MEM][1], 1'b0};
+            S_W_OP  : byteEn = 4'b1111;
+            S_BU_OP : byteEn = 4'b0001 << p_aluOut[MEM][1:0];
+            S_HU_OP : byteEn = 4'b0011 << {p_aluOut[MEM][1], 1'b0};
+            default : byteEn = 4'b1111;
+        endcase
+    end
 
     // --- [Stage]: Writeback ---
+    // Loads select their lane from the (word-aligned) data in
+    assign loadWord = i_dataIn >> {p_aluOut[MEM][1:0], 3'd0};
     always @(*) begin
         case (p_funct3[MEM])
-            L_B_OP  : loadData = {{24{i_dataIn[7]}},   i_dataIn[7:0]};
-            L_H_OP  : loadData = {{16{i_dataIn[15]}},  i_dataIn[15:0]};
-            L_W_OP  : loadData = i_dataIn;
-            L_BU_OP : loadData = {24'd0, i_dataIn[7:0]};
-            L_HU_OP : loadData = {16'd0, i_dataIn[15:0]};
-            default : loadData = i_dataIn;
+            L_B_OP  : loadData = {{24{loadWord[7]}},   loadWord[7:0]};
+            L_H_OP  : loadData = {{16{loadWord[15]}},  loadWord[15:0]};
+            L_W_OP  : loadData = loadWord;
+            L_BU_OP : loadData = {24'd0, loadWord[7:0]};
+            L_HU_OP : loadData = {16'd0, loadWord[15:0]};
+            default : loadData = loadWord;
         endcase
     end
 
@@ -281,5 +475,6 @@ module flintRV (
     assign o_storeReq   = p_mem_w[MEM];
     assign o_loadReq    = p_mem2reg[MEM];
     assign o_dataOut    = storeData;
+    assign o_byteEn     = byteEn; // Qualified by o_storeReq
 
 endmodule
@@ -71,9 +71,9 @@
 `define CTRL_MEM_W(x)       x[4:4]
 `define CTRL_EXEC_B(x)      x[5:5]
 `define CTRL_EXEC_A(x)      x[6:6]
-`define CTRL_ALU_OP(x)      x[11:7]
-`define CTRL_ECALL(x)       x[12:12]
-`define CTRL_EBREAK(x)      x[13:13]
+`define CTRL_ALU_OP(x)      x[12:7]
+`define CTRL_ECALL(x)       x[13:13]
+`define CTRL_EBREAK(x)      x[14:14]
 
 // RV32I Opcode types
 `define R                   7'b0110011
@@ -88,6 +88,9 @@
 `define U_AUIPC             7'b0010111
 `define J                   7'b1101111
 
+// RV32M funct7 (i.e. R-type w/ this funct7 is a multiply/divide op)
+`define FUNCT7_MULDIV       7'b0000001
+
 // EXEC operand select
 `define REG                 1'b0
 `define PC                  1'b1
@@ -98,21 +101,51 @@
 `define FALSE               1'b0
 
 // ALU Operation Types
-`define ALU_OP_ADD          5'b00000
-`define ALU_OP_PASSB        5'b00001
-`define ALU_OP_ADD4A        5'b00010
-`define ALU_OP_XOR          5'b00011
-`define ALU_OP_SRL          5'b00100
-`define ALU_OP_SRA          5'b00101
-`define ALU_OP_OR           5'b00110
-`define ALU_OP_AND          5'b00111
-`define ALU_OP_SUB          5'b01000
-`define ALU_OP_SLL          5'b01001
-`define ALU_OP_EQ           5'b01010
-`define ALU_OP_NEQ          5'b01011
-`define ALU_OP_SLT          5'b01100
-`define ALU_OP_SLTU         5'b01101
-`define ALU_OP_SGTE         5'b01110
-`define ALU_OP_SGTEU        5'b01111
+`define ALU_OP_ADD          6'b000000
+`define ALU_OP_PASSB        6'b000001
+`define ALU_OP_ADD4A        6'b000010
+`define ALU_OP_XOR          6'b000011
+`define ALU_OP_SRL          6'b000100
+`define ALU_OP_SRA          6'b000101
+`define ALU_OP_OR           6'b000110
+`define ALU_OP_AND          6'b000111
+`define ALU_OP_SUB          6'b001000
+`define ALU_OP_SLL          6'b001001
+`define ALU_OP_EQ           6'b001010
+`define ALU_OP_NEQ          6'b001011
+`define ALU_OP_SLT          6'b001100
+`define ALU_OP_SLTU         6'b001101
+`define ALU_OP_SGTE         6'b001110
+`define ALU_OP_SGTEU        6'b001111
+// RV32M Operation Types (handled by MulDiv unit - lower 3 bits are the instr funct3)
+`define ALU_OP_MUL          6'b010000
+`define ALU_OP_MULH         6'b010001
+`define ALU_OP_MULHSU       6'b010010
+`define ALU_OP_MULHU        6'b010011
+`define ALU_OP_DIV          6'b010100
+`define ALU_OP_DIVU         6'b010101
+`define ALU_OP_REM          6'b010110
+`define ALU_OP_REMU         6'b010111
+// Zba/Zbb Operation Types (ZB_EXT - encodings 1xxxxx)
+`define ALU_OP_ANDN         6'b100000
+`define ALU_OP_ORN          6'b100001
+`define ALU_OP_XNOR         6'b100010
+`define ALU_OP_CLZ          6'b100011
+`define ALU_OP_CTZ          6'b100100
+`define ALU_OP_CPOP         6'b100101
+`define ALU_OP_MIN          6'b100110
+`define ALU_OP_MAX          6'b100111
+`define ALU_OP_MINU         6'b101000
+`define ALU_OP_MAXU         6'b101001
+`define ALU_OP_SEXTB        6'b101010
+`define ALU_OP_SEXTH        6'b101011
+`define ALU_OP_ZEXTH        6'b101100
+`define ALU_OP_ROL          6'b101101
+`define ALU_OP_ROR          6'b101110
+`define ALU_OP_ORCB         6'b101111
+`define ALU_OP_REV8         6'b110000
+`define ALU_OP_SH1ADD       6'b110001
+`define ALU_OP_SH2ADD       6'b110010
+`define ALU_OP_SH3ADD       6'b110011
 
 `endif /* TYPES_VH */
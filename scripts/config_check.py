@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023 - present, Austin Annestrand
+# Licensed under the MIT License (see LICENSE file).
+
+import os
+import shutil
+import argparse
+import itertools
+import subprocess
+import concurrent.futures
+
+script_name = os.path.basename(__file__)
+src_dir     = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+# core_gen.py fetch side configs (RV32C cores only support the first one)
+frontends = [
+    [],
+    ["-ilat", "1"],
+    ["-if", "wishbone"],
+    ["-if", "axi4lite"],
+    ["-icache", "dm"],
+    ["-icache", "2way"],
+    ["-if", "wishbone", "-icache", "dm"],
+    ["-if", "axi4lite", "-icache", "2way"],
+]
+
+# CMake core options (flintRV_tests is built/run once per option, plus once w/ all of them off)
+cmake_options = ["RV32M", "BRANCH_PREDICTOR", "EARLY_BRANCH", "LOAD_FWD", "RV32C", "ZB_EXT"]
+
+def core_gen_configs():
+    for isa, ext in itertools.product(["rv32i", "rv32im", "rv32ic", "rv32imc"], ["", "_zba_zbb"]):
+        muldiv = itertools.product(["single", "registered"], ["radix2", "radix4"]) if "m" in isa[4:] else [(None, None)]
+        fronts = frontends[:1] if "c" in isa[4:] else frontends
+        for (mul, div), bp, bres, lfwd, front in itertools.product(muldiv, ["static", "bimodal"], ["mem", "exec"],
+                                                                   ["0", "1"], fronts):
+            cfg = ["-isa", isa + ext, "-bp", bp, "-bres", bres, "-lfwd", lfwd] + front
+            if mul is not None:
+                cfg += ["-mul", mul, "-div", div]
+            yield cfg
+
+def lint_config(args, index, cfg):
+    top = os.path.join(args.workDir, f"top_{index}.v")
+    gen = subprocess.run(["python3", os.path.join(src_dir, "scripts", "core_gen.py")] + cfg,
+                         stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if gen.returncode != 0:
+        return False, gen.stdout
+    with open(top, "w") as f:
+        f.write(gen.stdout)
+    if args.generateOnly:
+        return True, ""
+    lint = subprocess.run(["verilator", "--lint-only", "-Wall", "--top-module", "top", top] + args.lintArgs,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    return lint.returncode == 0, lint.stdout
+
+def run_lint(args):
+    configs = list(core_gen_configs())
+    failures = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = pool.map(lambda item: lint_config(args, *item), enumerate(configs))
+        for cfg, (ok, log) in zip(configs, results):
+            print(f"[{'PASS' if ok else 'FAIL'}]: core_gen.py {' '.join(cfg)}")
+            if not ok:
+                print(log)
+                failures += 1
+    print(f"[{script_name}]: {len(configs) - failures}/{len(configs)} core_gen.py configs "
+          f"{'generated' if args.generateOnly else 'lint clean'}")
+    return failures == 0
+
+def run_tests(args):
+    failures = []
+    for opt in [None] + cmake_options:
+        name = "default" if opt is None else opt
+        build = os.path.join(args.workDir, f"build_{name}")
+        cmds = [
+            ["cmake", "-S", src_dir, "-B", build, "-DBUILD_TESTS=ON"] + ([f"-D{opt}=ON"] if opt else []) +
+                args.cmakeArgs,
+            ["cmake", "--build", build, "--target", "flintRV_tests", "-j", str(args.jobs)],
+            [os.path.join(build, "flintRV_tests")],
+        ]
+        ok = all(subprocess.run(cmd).returncode == 0 for cmd in cmds)
+        print(f"[{'PASS' if ok else 'FAIL'}]: flintRV_tests ({name})")
+        if not ok:
+            failures.append(name)
+    print(f"[{script_name}]: {len(cmake_options) + 1 - len(failures)}/{len(cmake_options) + 1} CMake configs pass"
+          + (f" (failed: {', '.join(failures)})" if failures else ""))
+    return len(failures) == 0
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Lints every core_gen.py option combination (verilator --lint-only "
+                                                 "-Wall) and runs flintRV_tests once per CMake core option")
+    parser.add_argument("-w", dest="workDir", required=True, help="Work dir for the generated tops/builds")
+    parser.add_argument("-j", dest="jobs", default=os.cpu_count() or 1, type=int,
+                        help="Parallel lint jobs/build threads (default: CPU count)")
+    parser.add_argument("--tests", action="store_true", help="Also build/run flintRV_tests per CMake core option")
+    parser.add_argument("--generate-only", dest="generateOnly", action="store_true",
+                        help="Only check that core_gen.py accepts/generates every config (no lint)")
+    parser.add_argument("--lint-args", dest="lintArgs", nargs="+", default=[],
+                        help="Extra Verilator args for the lint runs")
+    parser.add_argument("--cmake-args", dest="cmakeArgs", nargs=argparse.REMAINDER, default=[],
+                        help="Extra CMake args for the test builds (e.g. the toolchain triple)")
+    args = parser.parse_args()
+    args.workDir = os.path.abspath(args.workDir)
+    return args
+
+if __name__ == "__main__":
+    args = parse_args()
+    if not args.generateOnly and shutil.which("verilator") is None:
+        print(f"[{script_name} - Error]: verilator not found in PATH")
+        exit(1)
+    os.makedirs(args.workDir, exist_ok=True)
+    ok = run_lint(args)
+    if args.tests:
+        ok = run_tests(args) and ok
+    exit(0 if ok else 1)
@@ -12,15 +12,85 @@ from enum import Enum
 # Supported ISA configs
 class CoreISAconfigs(Enum):
     RV32I   = 0
+    RV32IM  = 1
+    RV32IC  = 2
+    RV32IMC = 3
 isa_table = {
     "rv32i"     : CoreISAconfigs.RV32I,
+    "rv32im"    : CoreISAconfigs.RV32IM,
+    "rv32ic"    : CoreISAconfigs.RV32IC,
+    "rv32imc"   : CoreISAconfigs.RV32IMC,
+}
+# Optional ISA string suffixes (e.g. rv32im_zba_zbb)
+isa_ext_table = {
+    "_zba_zbb"  : "zbExt",
+}
+has_rv32c = lambda args: isa_table[args.ISA] in (CoreISAconfigs.RV32IC, CoreISAconfigs.RV32IMC)
+
+# Supported multiplier implementations (RV32M)
+class CoreMulImpls(Enum):
+    SINGLE      = 0
+    REGISTERED  = 1
+mul_table = {
+    "single"    : CoreMulImpls.SINGLE,
+    "registered": CoreMulImpls.REGISTERED,
+}
+
+# Supported divider implementations (RV32M)
+class CoreDivImpls(Enum):
+    RADIX2  = 0
+    RADIX4  = 1
+div_table = {
+    "radix2"    : CoreDivImpls.RADIX2,
+    "radix4"    : CoreDivImpls.RADIX4,
+}
+
+# Supported branch predictors
+class CoreBranchPredictors(Enum):
+    STATIC  = 0
+    BIMODAL = 1
+bp_table = {
+    "static"    : CoreBranchPredictors.STATIC,
+    "bimodal"   : CoreBranchPredictors.BIMODAL,
+}
+
+# Supported branch resolution stages
+class CoreBranchResolve(Enum):
+    MEM     = 0
+    EXEC    = 1
+bres_table = {
+    "mem"       : CoreBranchResolve.MEM,
+    "exec"      : CoreBranchResolve.EXEC,
+}
+
+# Supported instruction cache configs (value is the number of ways)
+class CoreICacheConfigs(Enum):
+    NONE    = 0
+    DM      = 1
+    TWO_WAY = 2
+icache_table = {
+    "none"      : CoreICacheConfigs.NONE,
+    "dm"        : CoreICacheConfigs.DM,
+    "2way"      : CoreICacheConfigs.TWO_WAY,
 }
 
 # Supported Interface schemes
 class CoreInterfaceSchemes(Enum):
-    NONE    = 0
+    NONE        = 0
+    WISHBONE    = 1
+    AXI4LITE    = 2
 interface_table = {
-    "none"     : CoreInterfaceSchemes.NONE,
+    "none"      : CoreInterfaceSchemes.NONE,
+    "wishbone"  : CoreInterfaceSchemes.WISHBONE,
+    "axi4lite"  : CoreInterfaceSchemes.AXI4LITE,
+}
+
+# Optional RTL sources (only bundled when used)
+optional_srcs = {
+    "CompressedDecoder.v" : lambda args: has_rv32c(args),
+    "ICache.v"          : lambda args: icache_table[args.icache] != CoreICacheConfigs.NONE,
+    "WishboneBridge.v"  : lambda args: interface_table[args.interface] == CoreInterfaceSchemes.WISHBONE,
+    "AxiLiteBridge.v"   : lambda args: interface_table[args.interface] == CoreInterfaceSchemes.AXI4LITE,
 }
 
 # =====================================================================================================================
@@ -42,58 +112,269 @@ def build_top_module(args):
     xlen                = 32
     instr_width         = 32
     regfile_addr_width  =  5
+    rv32m               =  0
+    rv32c               =  0
     # Check ISA type
     if isa_table[args.ISA] == CoreISAconfigs.RV32I:
         xlen                = 32
         instr_width         = 32
         regfile_addr_width  =  5
+    elif isa_table[args.ISA] == CoreISAconfigs.RV32IM:
+        xlen                = 32
+        instr_width         = 32
+        regfile_addr_width  =  5
+        rv32m               =  1
+    elif isa_table[args.ISA] == CoreISAconfigs.RV32IC:
+        xlen                = 32
+        instr_width         = 32
+        regfile_addr_width  =  5
+        rv32c               =  1
+    elif isa_table[args.ISA] == CoreISAconfigs.RV32IMC:
+        xlen                = 32
+        instr_width         = 32
+        regfile_addr_width  =  5
+        rv32m               =  1
+        rv32c               =  1
+    # Core instance (always wired through cpu_* nets)
+    core_src = inspect.cleandoc(f"""
+        flintRV #(
+            // CPU Configuration
+            .PC_START           ({args.pcStart}),
+            .REGFILE_ADDR_WIDTH ({regfile_addr_width}),
+            .INSTR_WIDTH        ({instr_width}),
+            .XLEN               ({xlen}),
+            .ICACHE_LATENCY     ({args.iLatency}),
+            .RV32M              ({rv32m}),
+            .MUL_IMPL           ({mul_table[args.mulImpl].value}),
+            .DIV_IMPL           ({div_table[args.divImpl].value}),
+            .BRANCH_PREDICTOR   ({bp_table[args.branchPredictor].value}),
+            .BHT_ADDR_WIDTH     ({args.bhtEntries.bit_length()-1}),
+            .BTB_ADDR_WIDTH     ({args.btbEntries.bit_length()-1}),
+            .EARLY_BRANCH       ({bres_table[args.branchResolve].value}),
+            .LOAD_FWD           ({args.loadFwd}),
+            .RV32C              ({rv32c}),
+            .ZB_EXT             ({args.zbExt})
+        ) flintRV_unit (
+            .i_clk              (i_clk          ),
+            .i_rst              (i_rst          ),
+            .i_ifValid          (cpu_ifValid    ),
+            .i_memValid         (cpu_memValid   ),
+            .i_instr            (cpu_instr      ),
+            .i_dataIn           (cpu_dataIn     ),
+            .o_storeReq         (cpu_storeReq   ),
+            .o_loadReq          (cpu_loadReq    ),
+            .o_pcOut            (cpu_pcOut      ),
+            .o_dataAddr         (cpu_dataAddr   ),
+            .o_dataOut          (cpu_dataOut    ),
+            .o_byteEn           (cpu_byteEn     )
+        );
+    """)
+    wires_src = inspect.cleandoc(f"""
+        wire [{instr_width-1}:0] cpu_instr;
+        wire [{xlen-1}:0] cpu_pcOut, cpu_dataIn, cpu_dataAddr, cpu_dataOut, fetch_addr, fetch_data;
+        wire [3:0] cpu_byteEn;
+        wire cpu_ifValid, cpu_memValid, cpu_storeReq, cpu_loadReq, fetch_req, fetch_valid;
+    """)
+    # Fetch path: core -> (optional I$) -> fetch port (req/valid)
+    if icache_table[args.icache] == CoreICacheConfigs.NONE:
+        fetch_src = inspect.cleandoc(f"""
+            assign fetch_req    = 1'b1;
+            assign fetch_addr   = cpu_pcOut;
+            assign cpu_ifValid  = fetch_valid;
+            assign cpu_instr    = fetch_data;
+        """)
+    else:
+        fetch_src = inspect.cleandoc(f"""
+            ICache #(
+                .XLEN               ({xlen}),
+                .WAYS               ({icache_table[args.icache].value}),
+                .SET_ADDR_WIDTH     ({(args.icSize // (args.icLine * icache_table[args.icache].value)).bit_length()-1}),
+                .LINE_ADDR_WIDTH    ({(args.icLine // 4).bit_length()-1})
+            ) ICACHE_unit (
+                .i_clk              (i_clk          ),
+                .i_rst              (i_rst          ),
+                .i_addr             (cpu_pcOut      ),
+                .o_valid            (cpu_ifValid    ),
+                .o_data             (cpu_instr      ),
+                .o_memReq           (fetch_req      ),
+                .o_memAddr          (fetch_addr     ),
+                .i_memValid         (fetch_valid    ),
+                .i_memData          (fetch_data     )
+            );
+        """)
     # Build top based on interface scheme
     if interface_table[args.interface] == CoreInterfaceSchemes.NONE:
-        top_src += f"""
-            module {args.topName} (
-                input i_clk,
-                input i_rst,
-                input i_ifValid,
-                input i_memValid,
-                input [{instr_width-1}:0] i_instr,
-                input [{xlen-1}:0] i_dataIn,
-                output o_storeReq,
-                output o_loadReq,
-                output [{xlen-1}:0] o_pcOut,
-                output [{xlen-1}:0] o_dataAddr,
-                output [{xlen-1}:0] o_dataOut
+        ports_src = inspect.cleandoc(f"""
+            input i_ifValid,
+            input i_memValid,
+            input [{instr_width-1}:0] i_instr,
+            input [{xlen-1}:0] i_dataIn,
+            output o_storeReq,
+            output o_loadReq,
+            output [{xlen-1}:0] o_pcOut,
+            output [{xlen-1}:0] o_dataAddr,
+            output [{xlen-1}:0] o_dataOut,
+            output [3:0] o_byteEn
+        """)
+        bus_src = inspect.cleandoc(f"""
+            assign o_pcOut      = fetch_addr;
+            assign fetch_valid  = i_ifValid;
+            assign fetch_data   = i_instr;
+            assign o_storeReq   = cpu_storeReq;
+            assign o_loadReq    = cpu_loadReq;
+            assign o_dataAddr   = cpu_dataAddr;
+            assign o_dataOut    = cpu_dataOut;
+            assign o_byteEn     = cpu_byteEn;
+            assign cpu_memValid = i_memValid;
+            assign cpu_dataIn   = i_dataIn;
+        """)
+    elif interface_table[args.interface] == CoreInterfaceSchemes.WISHBONE:
+        ports_src = ",\n".join(
+            f"output o_{bus}_cyc,\n"
+            f"output o_{bus}_stb,\n"
+            f"output o_{bus}_we,\n"
+            f"output [{xlen-1}:0] o_{bus}_adr,\n"
+            f"output [{xlen-1}:0] o_{bus}_dat,\n"
+            f"output [3:0] o_{bus}_sel,\n"
+            f"input [{xlen-1}:0] i_{bus}_dat,\n"
+            f"input i_{bus}_ack" for bus in ("iwb", "dwb"))
+        bus_src = "\n".join(inspect.cleandoc(f"""
+            WishboneBridge #(.XLEN({xlen})) {bus.upper()}_bridge (
+                .i_clk              (i_clk          ),
+                .i_rst              (i_rst          ),
+                .i_req              ({req:<15}),
+                .i_we               ({we:<15}),
+                .i_addr             ({addr:<15}),
+                .i_data             ({data:<15}),
+                .i_byteEn           ({byte_en:<15}),
+                .o_valid            ({valid:<15}),
+                .o_data             ({rdata:<15}),
+                .o_wb_cyc           (o_{bus}_cyc      ),
+                .o_wb_stb           (o_{bus}_stb      ),
+                .o_wb_we            (o_{bus}_we       ),
+                .o_wb_adr           (o_{bus}_adr      ),
+                .o_wb_dat           (o_{bus}_dat      ),
+                .o_wb_sel           (o_{bus}_sel      ),
+                .i_wb_dat           (i_{bus}_dat      ),
+                .i_wb_ack           (i_{bus}_ack      )
+            );
+        """) for bus, req, we, addr, data, byte_en, valid, rdata in (
+            ("iwb", "fetch_req", "1'b0", "fetch_addr", f"{xlen}'d0", "4'b1111", "fetch_valid", "fetch_data"),
+            ("dwb", "cpu_loadReq || cpu_storeReq", "cpu_storeReq", "cpu_dataAddr", "cpu_dataOut", "cpu_byteEn",
+                    "cpu_memValid", "cpu_dataIn")))
+    elif interface_table[args.interface] == CoreInterfaceSchemes.AXI4LITE:
+        read_ports = lambda bus: (
+            f"output [{xlen-1}:0] o_{bus}_araddr,\n"
+            f"output [2:0] o_{bus}_arprot,\n"
+            f"output o_{bus}_arvalid,\n"
+            f"input i_{bus}_arready,\n"
+            f"input [{xlen-1}:0] i_{bus}_rdata,\n"
+            f"input [1:0] i_{bus}_rresp,\n"
+            f"input i_{bus}_rvalid,\n"
+            f"output o_{bus}_rready")
+        ports_src = ",\n".join([read_ports("iaxi"), read_ports("daxi"),
+            f"output [{xlen-1}:0] o_daxi_awaddr,\n"
+            f"output [2:0] o_daxi_awprot,\n"
+            f"output o_daxi_awvalid,\n"
+            f"input i_daxi_awready,\n"
+            f"output [{xlen-1}:0] o_daxi_wdata,\n"
+            f"output [3:0] o_daxi_wstrb,\n"
+            f"output o_daxi_wvalid,\n"
+            f"input i_daxi_wready,\n"
+            f"input [1:0] i_daxi_bresp,\n"
+            f"input i_daxi_bvalid,\n"
+            f"output o_daxi_bready"])
+        bus_src = inspect.cleandoc(f"""
+            // Instruction port (read-only - write channels tied off)
+            AxiLiteBridge #(.XLEN({xlen}), .INSTR_PORT(1)) IAXI_bridge (
+                .i_clk              (i_clk          ),
+                .i_rst              (i_rst          ),
+                .i_req              (fetch_req      ),
+                .i_we               (1'b0           ),
+                .i_addr             (fetch_addr     ),
+                .i_data             ({xlen}'d0        ),
+                .i_byteEn           (4'b0000        ),
+                .o_valid            (fetch_valid    ),
+                .o_data             (fetch_data     ),
+                .o_axi_awaddr       (               ),
+                .o_axi_awprot       (               ),
+                .o_axi_awvalid      (               ),
+                .i_axi_awready      (1'b0           ),
+                .o_axi_wdata        (               ),
+                .o_axi_wstrb        (               ),
+                .o_axi_wvalid       (               ),
+                .i_axi_wready       (1'b0           ),
+                .i_axi_bresp        (2'b00          ),
+                .i_axi_bvalid       (1'b0           ),
+                .o_axi_bready       (               ),
+                .o_axi_araddr       (o_iaxi_araddr  ),
+                .o_axi_arprot       (o_iaxi_arprot  ),
+                .o_axi_arvalid      (o_iaxi_arvalid ),
+                .i_axi_arready      (i_iaxi_arready ),
+                .i_axi_rdata        (i_iaxi_rdata   ),
+                .i_axi_rresp        (i_iaxi_rresp   ),
+                .i_axi_rvalid       (i_iaxi_rvalid  ),
+                .o_axi_rready       (o_iaxi_rready  )
+            );
+            // Data port
+            AxiLiteBridge #(.XLEN({xlen}), .INSTR_PORT(0)) DAXI_bridge (
+                .i_clk              (i_clk          ),
+                .i_rst              (i_rst          ),
+                .i_req              (cpu_loadReq || cpu_storeReq),
+                .i_we               (cpu_storeReq   ),
+                .i_addr             (cpu_dataAddr   ),
+                .i_data             (cpu_dataOut    ),
+                .i_byteEn           (cpu_byteEn     ),
+                .o_valid            (cpu_memValid   ),
+                .o_data             (cpu_dataIn     ),
+                .o_axi_awaddr       (o_daxi_awaddr  ),
+                .o_axi_awprot       (o_daxi_awprot  ),
+                .o_axi_awvalid      (o_daxi_awvalid ),
+                .i_axi_awready      (i_daxi_awready ),
+                .o_axi_wdata        (o_daxi_wdata   ),
+                .o_axi_wstrb        (o_daxi_wstrb   ),
+                .o_axi_wvalid       (o_daxi_wvalid  ),
+                .i_axi_wready       (i_daxi_wready  ),
+                .i_axi_bresp        (i_daxi_bresp   ),
+                .i_axi_bvalid       (i_daxi_bvalid  ),
+                .o_axi_bready       (o_daxi_bready  ),
+                .o_axi_araddr       (o_daxi_araddr  ),
+                .o_axi_arprot       (o_daxi_arprot  ),
+                .o_axi_arvalid      (o_daxi_arvalid ),
+                .i_axi_arready      (i_daxi_arready ),
+                .i_axi_rdata        (i_daxi_rdata   ),
+                .i_axi_rresp        (i_daxi_rresp   ),
+                .i_axi_rvalid       (i_daxi_rvalid  ),
+                .o_axi_rready       (o_daxi_rready  )
             );
-                flintRV #(
-                    // CPU Configuration
-                    .PC_START           ({args.pcStart}),
-                    .REGFILE_ADDR_WIDTH ({regfile_addr_width}),
-                    .INSTR_WIDTH        ({instr_width}),
-                    .XLEN               ({xlen}),
-                    .ICACHE_LATENCY     ({args.iLatency})
-                ) flintRV_unit (
-                    .i_clk              (i_clk     ),
-                    .i_rst              (i_rst     ),
-                    .i_ifValid          (i_ifValid ),
-                    .i_memValid         (i_memValid),
-                    .i_instr            (i_instr   ),
-                    .i_dataIn           (i_dataIn  ),
-                    .o_storeReq         (o_storeReq),
-                    .o_loadReq          (o_loadReq ),
-                    .o_pcOut            (o_pcOut   ),
-                    .o_dataAddr         (o_dataAddr),
-                    .o_dataOut          (o_dataOut )
-                );
-            endmodule
-        """
-    return inspect.cleandoc(top_src).lstrip()
+        """)
+    indent = lambda src: "\n".join(("    " + line) if line else line for line in src.splitlines())
+    top_src += f"module {args.topName} (\n"
+    top_src += indent("input i_clk,\ninput i_rst,\n" + ports_src) + "\n);\n"
+    top_src += "\n\n".join(indent(x) for x in (wires_src, fetch_src, bus_src, core_src)) + "\n"
+    top_src += "endmodule"
+    return top_src
 
 # =====================================================================================================================
 def parse_has_err(args, unknown):
     file_name       = os.path.basename(__file__)
     args.interface  = str.lower(args.interface)
     args.ISA        = str.lower(args.ISA)
+    for suffix, attr in isa_ext_table.items():
+        setattr(args, attr, int(args.ISA.endswith(suffix)))
+        args.ISA = args.ISA[:-len(suffix)] if args.ISA.endswith(suffix) else args.ISA
+    args.mulImpl    = str.lower(args.mulImpl)
+    args.divImpl    = str.lower(args.divImpl)
+    args.branchPredictor = str.lower(args.branchPredictor)
+    args.bhtEntries = int(args.bhtEntries)
+    args.branchResolve = str.lower(args.branchResolve)
+    args.btbEntries = int(args.btbEntries)
     args.pcStart    = int(args.pcStart, 16) if args.pcStart[:2] == "0x" else int(args.pcStart)
     args.iLatency   = int(args.iLatency)
+    args.loadFwd    = int(args.loadFwd)
+    args.icache     = str.lower(args.icache)
+    args.icSize     = int(args.icSize)
+    args.icLine     = int(args.icLine)
     if len(unknown) != 0:
         print(f"[{file_name} - Error]: Unknown argument(s)/option(s): {unknown}\n")
         return False
@@ -103,8 +384,30 @@ def parse_has_err(args, unknown):
         return False
     if args.ISA not in isa_table:
         print(f"[{file_name} - Error]: Invalid CPU ISA option: [ {args.ISA} ]")
-        print(f"    Please use one of the following: {list(isa_table.keys())}\n")
+        print(f"    Please use one of the following: {list(isa_table.keys())}")
+        print(f"    (optionally suffixed w/ any of: {list(isa_ext_table.keys())})\n")
         return False
+    if args.mulImpl not in mul_table:
+        print(f"[{file_name} - Error]: Invalid multiplier option: [ {args.mulImpl} ]")
+        print(f"    Please use one of the following: {list(mul_table.keys())}\n")
+        return False
+    if args.divImpl not in div_table:
+        print(f"[{file_name} - Error]: Invalid divider option: [ {args.divImpl} ]")
+        print(f"    Please use one of the following: {list(div_table.keys())}\n")
+        return False
+    if args.branchPredictor not in bp_table:
+        print(f"[{file_name} - Error]: Invalid branch predictor option: [ {args.branchPredictor} ]")
+        print(f"    Please use one of the following: {list(bp_table.keys())}\n")
+        return False
+    if args.branchResolve not in bres_table:
+        print(f"[{file_name} - Error]: Invalid branch resolve stage option: [ {args.branchResolve} ]")
+        print(f"    Please use one of the following: {list(bres_table.keys())}\n")
+        return False
+    for name, entries in (("BHT", args.bhtEntries), ("BTB", args.btbEntries)):
+        if entries < 2 or (entries & (entries - 1)) != 0:
+            print(f"[{file_name} - Error]: Invalid {name} size: [ {entries} ].")
+            print(f"    Must be a power of 2 (>= 2)\n")
+            return False
     if not abs(int(args.pcStart)) <= 0xffffffff:
         print(f"[{file_name} - Error]: PC start value out of range: [ {args.pcStart} ].")
         print(f"    Valid range: [0x0 - 0xffffffff]\n")
@@ -113,6 +416,34 @@ def parse_has_err(args, unknown):
         print(f"[{file_name} - Error]: Invalid instruction cache latency value: [ {args.iLatency} ].")
         print(f"    Valid values: [0 or 1] - 0:combinatorial, 1:BRAM\n")
         return False
+    if args.icache not in icache_table:
+        print(f"[{file_name} - Error]: Invalid instruction cache option: [ {args.icache} ]")
+        print(f"    Please use one of the following: {list(icache_table.keys())}\n")
+        return False
+    if icache_table[args.icache] != CoreICacheConfigs.NONE:
+        ways = icache_table[args.icache].value
+        for name, val in (("size", args.icSize), ("line size", args.icLine)):
+            if val <= 0 or (val & (val - 1)) != 0:
+                print(f"[{file_name} - Error]: Invalid instruction cache {name}: [ {val} ].")
+                print(f"    Must be a power of 2 (in bytes)\n")
+                return False
+        if args.icLine < 8 or args.icSize < 2 * ways * args.icLine:
+            print(f"[{file_name} - Error]: Invalid instruction cache geometry: [ {args.icSize}B / {args.icLine}B lines ].")
+            print(f"    Line size must be >= 8B and the cache must have >= 2 sets\n")
+            return False
+    if (interface_table[args.interface] != CoreInterfaceSchemes.NONE or
+        icache_table[args.icache] != CoreICacheConfigs.NONE) and args.iLatency != 0:
+        print(f"[{file_name} - Error]: Bus interfaces and the instruction cache require [ -ilat 0 ].\n")
+        return False
+    if has_rv32c(args) and (args.iLatency != 0 or interface_table[args.interface] != CoreInterfaceSchemes.NONE or
+                            icache_table[args.icache] != CoreICacheConfigs.NONE):
+        print(f"[{file_name} - Error]: RV32C requires [ -ilat 0 -if none -icache none ].")
+        print(f"    The fetch port must return 32b at any 16b-aligned PC in the same cycle\n")
+        return False
+    if args.loadFwd < 0 or args.loadFwd > 1:
+        print(f"[{file_name} - Error]: Invalid load forwarding value: [ {args.loadFwd} ].")
+        print(f"    Valid values: [0 or 1] - 0:load-use bubble, 1:forward load data from MEM\n")
+        return False
     return True
 
 # =====================================================================================================================
@@ -122,15 +453,39 @@ if __name__ == "__main__":
     parser = argparse.ArgumentParser(allow_abbrev=False,
         description="Helper utility to config CPU top module and generate top module to stdout.")
     parser.add_argument("-if", dest="interface", default="none",
-        help="Specify which CPU interface to use [Default: None].")
+        help=f"Specify which CPU interface to use {list(interface_table.keys())} [Default: None].")
     parser.add_argument("-isa", dest="ISA", default="rv32i",
-        help="Specify which CPU ISA to use [Default: rv32i].")
+        help=f"Specify which CPU ISA to use {list(isa_table.keys())}, optionally suffixed w/ "
+             f"{list(isa_ext_table.keys())} for the Zba/Zbb bit-manipulation ops [Default: rv32i].")
     parser.add_argument("-pc", dest="pcStart", default="0",
         help="PC start/reset value (Prefix value with '0x' for hex). [Default: 0x0].")
     parser.add_argument("-name", dest="topName", default="top",
         help="Generated top module name. [Default: top].")
     parser.add_argument("-ilat", dest="iLatency", default="0",
         help="Latency of the attached instruction cache (0cc - 1cc). [Default: 0].")
+    parser.add_argument("-mul", dest="mulImpl", default="single",
+        help="RV32M multiplier implementation (single: 1cc DSP, registered: DSP w/ input/output regs, 2cc stall, no overlap). [Default: single].")
+    parser.add_argument("-div", dest="divImpl", default="radix2",
+        help="RV32M iterative divider implementation (radix2: 1 bit/cc, radix4: 2 bits/cc). [Default: radix2].")
+    parser.add_argument("-bp", dest="branchPredictor", default="static",
+        help="Branch predictor (static: not-taken, bimodal: 2-bit BHT + BTB). [Default: static].")
+    parser.add_argument("-bht", dest="bhtEntries", default="64",
+        help="Number of BHT entries for the bimodal predictor (power of 2). [Default: 64].")
+    parser.add_argument("-btb", dest="btbEntries", default="16",
+        help="Number of BTB entries for the bimodal predictor (power of 2). [Default: 16].")
+    parser.add_argument("-bres", dest="branchResolve", default="mem",
+        help="Pipeline stage that resolves branches/jumps (mem: 2cc redirect penalty, exec: 1cc - longer EXEC path). "
+             "[Default: mem].")
+    parser.add_argument("-icache", dest="icache", default="none",
+        help="Instruction cache in front of the fetch port (none, dm: direct-mapped, 2way: 2-way LRU). "
+             "[Default: none].")
+    parser.add_argument("-icsize", dest="icSize", default="1024",
+        help="Instruction cache size in bytes (power of 2). [Default: 1024].")
+    parser.add_argument("-icline", dest="icLine", default="16",
+        help="Instruction cache line size in bytes (power of 2, >= 8). [Default: 16].")
+    parser.add_argument("-lfwd", dest="loadFwd", default="0",
+        help="Forward load data from MEM into EXEC, removing the load-use bubble (0 - 1). "
+             "Adds the data-in path to EXEC. [Default: 0].")
 
     # Parse and err check
     args, unknown = parser.parse_known_args()
@@ -143,7 +498,8 @@ if __name__ == "__main__":
 
     # Dump final src file to stdout
     src_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", "rtl"))
-    srcs = [x for x in os.listdir(src_dir) if x != "types.vh"]
+    srcs = [x for x in sorted(os.listdir(src_dir))
+        if x != "types.vh" and (x not in optional_srcs or optional_srcs[x](args))]
     print_generated_banner()
     with open(os.path.join(src_dir, "types.vh"), 'r') as core_header_fp:
         print(core_header_fp.read())
@@ -17,7 +17,8 @@ if __name__ == "__main__":
     core_rtl        = subprocess.run(command, stdout=subprocess.PIPE, encoding='utf-8').stdout
     # Concatenate [SoC srcs + core] to 1 file
     src_dir         = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", "examples", "flintRVsoc"))
-    soc_srcs        = [os.path.join(src_dir, "bootrom.v"), os.path.join(src_dir, "flintRVsoc.v")]
+    soc_srcs        = [os.path.join(src_dir, "bootrom.v"), os.path.join(src_dir, "dataram.v"),
+                       os.path.join(src_dir, "flintRVsoc.v")]
     # Output core RTL
     core_rtl        = re.sub(r"\[ core_gen.py \]", f"[ {os.path.basename(__file__)} ]", core_rtl)
     print(core_rtl)
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023 - present, Austin Annestrand
+# Licensed under the MIT License (see LICENSE file).
+
+import os
+import glob
+import shutil
+import argparse
+import subprocess
+
+script_name = os.path.basename(__file__)
+
+def run(cmd, cwd=None):
+    print(f"[{script_name}]: {' '.join(cmd)}")
+    if subprocess.run(cmd, cwd=cwd).returncode != 0:
+        print(f"[{script_name} - Error]: Command failed: [ {' '.join(cmd)} ]")
+        exit(1)
+
+def build_phase(args, phase):
+    # NOTE: Both phases share one build dir - GCC keys its profiles on object file paths
+    run(["cmake", "-S", args.srcDir, "-B", args.buildDir, "-G", args.generator, f"-DPGO_PHASE={phase}",
+         f"-DPGO_PROFILE_DIR={args.profileDir}"] + args.cmakeArgs)
+    run(["cmake", "--build", args.buildDir, "--target", "flintRV"])
+    return os.path.join(args.buildDir, "flintRV")
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Profile-guided (Verilator + host compiler) build of the flintRV driver")
+    parser.add_argument("-s", dest="srcDir", required=True, help="flintRV source dir")
+    parser.add_argument("-b", dest="buildDir", required=True, help="Build dir for the PGO build")
+    parser.add_argument("-g", dest="generator", default="Ninja", help="CMake generator (default: Ninja)")
+    parser.add_argument("-p", dest="programs", metavar="HEX", nargs="+", required=True,
+                        help="Training workload program binaries (.hex)")
+    parser.add_argument("-m", dest="memSize", default="0x8000", help="Memory size in bytes (default: 0x8000)")
+    parser.add_argument("--baseline", default=None, help="Non-PGO flintRV driver to benchmark against")
+    parser.add_argument("--cmake-args", dest="cmakeArgs", nargs=argparse.REMAINDER, default=[],
+                        help="Extra CMake args for the PGO build (i.e. the core config)")
+    args = parser.parse_args()
+    args.buildDir   = os.path.abspath(args.buildDir)
+    args.profileDir = os.path.join(args.buildDir, "pgo-profile")
+    return args
+
+if __name__ == "__main__":
+    args = parse_args()
+    for path in args.programs:
+        if not os.path.exists(path):
+            print(f"[{script_name} - Error]: Program does not exist: [ {path} ]")
+            exit(1)
+
+    # 1. Instrumented build
+    shutil.rmtree(args.profileDir, ignore_errors=True)
+    os.makedirs(args.profileDir)
+    driver = build_phase(args, "GENERATE")
+
+    # 2. Training runs (Verilator writes profile.vlt to the working dir)
+    for program in args.programs:
+        run([driver, "-m", args.memSize, os.path.abspath(program)], cwd=args.profileDir)
+    rawProfiles = glob.glob(os.path.join(args.profileDir, "*.profraw"))
+    if len(rawProfiles) > 0: # Clang
+        run(["llvm-profdata", "merge", "-o", os.path.join(args.profileDir, "default.profdata")] + rawProfiles)
+
+    # 3. Optimized rebuild
+    driver = build_phase(args, "USE")
+
+    # 4. Before/after report
+    if args.baseline is not None:
+        run(["python3", os.path.join(args.srcDir, "scripts", "sim_bench.py"), "-d", args.baseline, driver,
+             "-m", args.memSize, "-p"] + args.programs)
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023 - present, Austin Annestrand
+# Licensed under the MIT License (see LICENSE file).
+
+import os
+import re
+import argparse
+import subprocess
+
+# Parsed from the flintRV driver's exit log
+speed_re    = re.compile(r"Simulation speed: ([0-9.]+) cycles/second")
+cycles_re   = re.compile(r"Cycles: ([0-9]+),")
+
+def run_driver(driver, program, mem_size):
+    cmd = [driver, "-m", str(mem_size), program, "--noPerf"]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    speed   = speed_re.search(out.stdout)
+    cycles  = cycles_re.search(out.stdout)
+    if out.returncode != 0 or speed is None or cycles is None:
+        print(f"[{os.path.basename(__file__)} - Error]: [ {' '.join(cmd)} ] failed:")
+        print(out.stdout)
+        exit(1)
+    return int(cycles.group(1)), float(speed.group(1))
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Reports simulated cycles/second of flintRV driver variants")
+    parser.add_argument("-d", dest="drivers", metavar="DRIVER", nargs="+", required=True,
+                        help="flintRV driver executables (first one is the baseline)")
+    parser.add_argument("-p", dest="programs", metavar="HEX", nargs="+", required=True,
+                        help="Program binaries (.hex) to run")
+    parser.add_argument("-m", dest="memSize", default=0x8000, type=lambda x: int(x, 0),
+                        help="Memory size in bytes (default: 0x8000)")
+    parser.add_argument("-r", dest="runs", default=3, type=int,
+                        help="Runs per driver/program, best is reported (default: 3)")
+    return parser.parse_args()
+
+if __name__ == "__main__":
+    args = parse_args()
+    for path in args.drivers + args.programs:
+        if not os.path.exists(path):
+            print(f"[{os.path.basename(__file__)} - Error]: File does not exist: [ {path} ]")
+            exit(1)
+
+    print(f"{'program':<16}{'driver':<32}{'cycles':>12}{'cycles/s':>16}{'speedup':>10}")
+    for program in args.programs:
+        baseline = None
+        for driver in args.drivers:
+            results = [run_driver(driver, program, args.memSize) for _ in range(max(args.runs, 1))]
+            cycles  = results[0][0]
+            speed   = max(r[1] for r in results)
+            baseline = speed if baseline is None else baseline
+            speedup = (speed / baseline) if baseline > 0 else 0.0
+            name    = os.path.join(os.path.basename(os.path.dirname(os.path.abspath(driver))),
+                                   os.path.basename(driver))
+            print(f"{os.path.basename(program):<16}{name:<32}{cycles:>12}{speed:>16.0f}"
+                  f"{speedup:>9.2f}x")
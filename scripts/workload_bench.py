@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023 - present, Austin Annestrand
+# Licensed under the MIT License (see LICENSE file).
+
+import os
+import re
+import json
+import time
+import argparse
+import tempfile
+import subprocess
+
+# Printed by the workloads (see tests/workloads/report.h)
+result_re   = re.compile(r"(\w+): ([0-9]+) iterations, checksum (0x[0-9a-f]+)")
+
+def run_sim(cmd):
+    start   = time.perf_counter()
+    out     = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    elapsed = time.perf_counter() - start
+    result  = result_re.search(out.stdout)
+    if out.returncode != 0 or result is None:
+        print(f"[{os.path.basename(__file__)} - Error]: [ {' '.join(cmd)} ] failed:")
+        print(out.stdout)
+        exit(1)
+    return int(result.group(2)), result.group(3), elapsed
+
+def run_risa(risa, program, mem_size):
+    iterations, checksum, elapsed = run_sim([risa, "-m", str(mem_size), program])
+    return {"iterations": iterations, "checksum": checksum, "wallTime": elapsed}
+
+def run_driver(driver, program, mem_size):
+    with tempfile.TemporaryDirectory() as tmp:
+        perf_file = os.path.join(tmp, "perf.json")
+        iterations, checksum, elapsed = run_sim([driver, "-m", str(mem_size), program, "--perfJson", perf_file])
+        with open(perf_file) as f:
+            perf = json.load(f)
+    return {"iterations": iterations, "checksum": checksum, "wallTime": elapsed, "cycles": perf["cycles"],
+            "cpi": perf["cpi"]}
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Reports iterations/second (of each simulator) and CPI (of the "
+                                                 "flintRV core) for the tests/workloads programs")
+    parser.add_argument("-r", dest="risa", metavar="RISA", required=True,
+                        help="rISA executable")
+    parser.add_argument("-d", dest="drivers", metavar="DRIVER", nargs="+", required=True,
+                        help="flintRV driver executables")
+    parser.add_argument("-p", dest="programs", metavar="HEX", nargs="+", required=True,
+                        help="Workload binaries (.hex) to run")
+    parser.add_argument("-m", dest="memSize", default=0x8000, type=lambda x: int(x, 0),
+                        help="Memory size in bytes (default: 0x8000)")
+    parser.add_argument("-o", dest="output", metavar="JSON", default=None,
+                        help="Also write the results to a JSON file")
+    return parser.parse_args()
+
+if __name__ == "__main__":
+    args = parse_args()
+    for path in [args.risa] + args.drivers + args.programs:
+        if not os.path.exists(path):
+            print(f"[{os.path.basename(__file__)} - Error]: File does not exist: [ {path} ]")
+            exit(1)
+
+    results = []
+    print(f"{'workload':<20}{'simulator':<32}{'iterations':>12}{'iter/s':>12}{'cycles/iter':>14}{'CPI':>8}")
+    for program in args.programs:
+        runs = [(args.risa, run_risa(args.risa, program, args.memSize))]
+        runs += [(driver, run_driver(driver, program, args.memSize)) for driver in args.drivers]
+        for sim, run in runs:
+            name    = os.path.join(os.path.basename(os.path.dirname(os.path.abspath(sim))), os.path.basename(sim))
+            rate    = run["iterations"] / run["wallTime"] if run["wallTime"] > 0 else 0.0
+            per_it  = f"{run['cycles'] / run['iterations']:.0f}" if "cycles" in run else "-"
+            cpi     = f"{run['cpi']:.3f}" if "cpi" in run else "-"
+            if run["checksum"] != runs[0][1]["checksum"]:
+                print(f"[{os.path.basename(__file__)} - Error]: {name} checksum {run['checksum']} differs from "
+                      f"rISA's {runs[0][1]['checksum']} on {os.path.basename(program)}")
+                exit(1)
+            print(f"{os.path.basename(program):<20}{name:<32}{run['iterations']:>12}{rate:>12.1f}{per_it:>14}"
+                  f"{cpi:>8}")
+            results.append(dict(run, workload=os.path.basename(program), simulator=name))
+
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=4)
@@ -25,10 +25,232 @@ bool loadMem(std::string filePath, char *mem, ssize_t memLen) {
         }
         fread(mem + i, 1, 1, fp);
     }
+    fclose(fp);
     return true;
 }
 
+// Expand a 16b RV32C instruction to its 32b RV32I equivalent (mirrors
+// rtl/CompressedDecoder.v)
+u32 expandCompressed(u16 instr) {
+    auto bits = [&](int pos, int width) -> u32 {
+        return get_bits(instr, pos, width);
+    };
+    // Sign-extend the low (width) bits of x
+    auto sext = [](u32 x, int width) -> u32 {
+        return (u32)((s32)(x << (32 - width)) >> (32 - width));
+    };
+    // 32b encoders
+    auto iType = [](u32 imm, u32 rs1, u32 funct3, u32 rd, u32 op) -> u32 {
+        return (imm & 0xfff) << 20 | rs1 << 15 | funct3 << 12 | rd << 7 | op;
+    };
+    auto rType = [](u32 funct7, u32 rs2, u32 rs1, u32 funct3, u32 rd,
+                    u32 op) -> u32 {
+        return funct7 << 25 | rs2 << 20 | rs1 << 15 | funct3 << 12 | rd << 7 |
+               op;
+    };
+    auto sType = [](u32 imm, u32 rs2, u32 rs1, u32 funct3) -> u32 {
+        return ((imm >> 5) & 0x7f) << 25 | rs2 << 20 | rs1 << 15 |
+               funct3 << 12 | (imm & 0x1f) << 7 | 0x23;
+    };
+    auto bType = [](u32 imm, u32 rs2, u32 rs1, u32 funct3) -> u32 {
+        return ((imm >> 12) & 0x1) << 31 | ((imm >> 5) & 0x3f) << 25 |
+               rs2 << 20 | rs1 << 15 | funct3 << 12 | ((imm >> 1) & 0xf) << 8 |
+               ((imm >> 11) & 0x1) << 7 | 0x63;
+    };
+    auto jType = [](u32 imm, u32 rd) -> u32 {
+        return ((imm >> 20) & 0x1) << 31 | ((imm >> 1) & 0x3ff) << 21 |
+               ((imm >> 11) & 0x1) << 20 | ((imm >> 12) & 0xff) << 12 |
+               rd << 7 | 0x6f;
+    };
+    constexpr u32 X0 = 0, RA = 1, SP = 2;
+    const u32 rd = bits(7, 5);
+    const u32 rs2 = bits(2, 5);
+    const u32 rdP = 8 + bits(2, 3);
+    const u32 rs1P = 8 + bits(7, 3);
+    const u32 imm6 = sext(bits(12, 1) << 5 | bits(2, 5), 6);
+    const u32 lwImm = bits(5, 1) << 6 | bits(10, 3) << 3 | bits(6, 1) << 2;
+    const u32 jImm = sext(bits(12, 1) << 11 | bits(8, 1) << 10 |
+                              bits(9, 2) << 8 | bits(6, 1) << 7 |
+                              bits(7, 1) << 6 | bits(2, 1) << 5 |
+                              bits(11, 1) << 4 | bits(3, 3) << 1,
+                          12);
+    const u32 bImm = sext(bits(12, 1) << 8 | bits(5, 2) << 6 | bits(2, 1) << 5 |
+                              bits(10, 2) << 3 | bits(3, 2) << 1,
+                          9);
+    switch (bits(13, 3) << 2 | bits(0, 2)) {
+        // Quadrant 0
+        case 0b00000: { // C.ADDI4SPN
+            u32 imm = bits(7, 4) << 6 | bits(11, 2) << 4 | bits(5, 1) << 3 |
+                      bits(6, 1) << 2;
+            return (imm == 0) ? COMPRESSED_ILLEGAL
+                              : iType(imm, SP, 0b000, rdP, 0x13);
+        }
+        case 0b01000: // C.LW
+            return iType(lwImm, rs1P, 0b010, rdP, 0x03);
+        case 0b11000: // C.SW
+            return sType(lwImm, rdP, rs1P, 0b010);
+        // Quadrant 1
+        case 0b00001: // C.ADDI/C.NOP
+            return iType(imm6, rd, 0b000, rd, 0x13);
+        case 0b00101: // C.JAL
+            return jType(jImm, RA);
+        case 0b01001: // C.LI
+            return iType(imm6, X0, 0b000, rd, 0x13);
+        case 0b01101: {
+            if (rd == SP) { // C.ADDI16SP
+                u32 imm = sext(bits(12, 1) << 9 | bits(3, 2) << 7 |
+                                   bits(5, 1) << 6 | bits(2, 1) << 5 |
+                                   bits(6, 1) << 4,
+                               10);
+                return (imm == 0) ? COMPRESSED_ILLEGAL
+                                  : iType(imm, SP, 0b000, SP, 0x13);
+            }
+            // C.LUI
+            return (imm6 == 0) ? COMPRESSED_ILLEGAL
+                               : (imm6 & 0xfffff) << 12 | rd << 7 | 0x37;
+        }
+        case 0b10001: {
+            switch (bits(10, 2)) {
+                case 0b00: // C.SRLI
+                    return bits(12, 1) ? COMPRESSED_ILLEGAL
+                                       : iType(rs2, rs1P, 0b101, rs1P, 0x13);
+                case 0b01: // C.SRAI
+                    return bits(12, 1)
+                               ? COMPRESSED_ILLEGAL
+                               : iType(0x400 | rs2, rs1P, 0b101, rs1P, 0x13);
+                case 0b10: // C.ANDI
+                    return iType(imm6, rs1P, 0b111, rs1P, 0x13);
+                default: {
+                    // C.SUB/C.XOR/C.OR/C.AND (RV64 C.SUBW/C.ADDW are illegal)
+                    const u32 funct3[] = {0b000, 0b100, 0b110, 0b111};
+                    if (bits(12, 1)) {
+                        return COMPRESSED_ILLEGAL;
+                    }
+                    return rType(bits(5, 2) == 0 ? 0x20 : 0x00, rdP, rs1P,
+                                 funct3[bits(5, 2)], rs1P, 0x33);
+                }
+            }
+        }
+        case 0b10101: // C.J
+            return jType(jImm, X0);
+        case 0b11001: // C.BEQZ
+            return bType(bImm, X0, rs1P, 0b000);
+        case 0b11101: // C.BNEZ
+            return bType(bImm, X0, rs1P, 0b001);
+        // Quadrant 2
+        case 0b00010: // C.SLLI
+            return bits(12, 1) ? COMPRESSED_ILLEGAL
+                               : iType(rs2, rd, 0b001, rd, 0x13);
+        case 0b01010: { // C.LWSP
+            u32 imm = bits(2, 2) << 6 | bits(12, 1) << 5 | bits(4, 3) << 2;
+            return (rd == X0) ? COMPRESSED_ILLEGAL
+                                : iType(imm, SP, 0b010, rd, 0x03);
+        }
+        case 0b10010: {
+            if (!bits(12, 1)) {
+                if (rs2 == X0) { // C.JR
+                    return (rd == X0) ? COMPRESSED_ILLEGAL
+                                        : iType(0, rd, 0b000, X0, 0x67);
+                }
+                // C.MV
+                return rType(0x00, rs2, X0, 0b000, rd, 0x33);
+            }
+            if (rs2 == X0) { // C.EBREAK/C.JALR
+                return (rd == X0) ? (u32)EBREAK
+                                    : iType(0, rd, 0b000, RA, 0x67);
+            }
+            // C.ADD
+            return rType(0x00, rs2, rd, 0b000, rd, 0x33);
+        }
+        case 0b11010: { // C.SWSP
+            u32 imm = bits(7, 2) << 6 | bits(9, 4) << 2;
+            return sType(imm, rs2, SP, 0b010);
+        }
+        default:
+            return COMPRESSED_ILLEGAL;
+    }
+}
+
+// Result of a Zba/Zbb instruction (id as keyed in the Zba/Zbb enum, b is rs2
+// or the shift amount for rori - unused by the unary ops)
+u32 executeZb(u32 id, u32 a, u32 b) {
+    auto rotr = [](u32 x, u32 n) -> u32 {
+        n &= 0x1f;
+        return (n == 0) ? x : (x >> n) | (x << (32 - n));
+    };
+    switch (id) {
+        case ANDN:
+            return a & ~b;
+        case ORN:
+            return a | ~b;
+        case XNOR:
+            return ~(a ^ b);
+        case MIN:
+            return ((s32)a < (s32)b) ? a : b;
+        case MINU:
+            return (a < b) ? a : b;
+        case MAX:
+            return ((s32)a < (s32)b) ? b : a;
+        case MAXU:
+            return (a < b) ? b : a;
+        case ROL:
+            return rotr(a, 32 - (b & 0x1f));
+        case ROR:
+        case RORI:
+            return rotr(a, b);
+        case ZEXT_H:
+            return a & 0xffff;
+        case SH1ADD:
+            return (a << 1) + b;
+        case SH2ADD:
+            return (a << 2) + b;
+        case SH3ADD:
+            return (a << 3) + b;
+        case CLZ: {
+            u32 n = 0;
+            for (; n < 32 && !(a & (0x80000000u >> n)); ++n) {
+            }
+            return n;
+        }
+        case CTZ: {
+            u32 n = 0;
+            for (; n < 32 && !(a & (0x1u << n)); ++n) {
+            }
+            return n;
+        }
+        case CPOP: {
+            u32 n = 0;
+            for (; a != 0; a &= a - 1) {
+                ++n;
+            }
+            return n;
+        }
+        case SEXT_B:
+            return (u32)(s32)(s8)a;
+        case SEXT_H:
+            return (u32)(s32)(s16)a;
+        case ORC_B: {
+            u32 r = 0;
+            for (int i = 0; i < 32; i += 8) {
+                r |= ((a >> i) & 0xff) ? (0xffu << i) : 0;
+            }
+            return r;
+        }
+        case REV8:
+            return (a << 24) | ((a & 0xff00) << 8) | ((a >> 8) & 0xff00) |
+                   (a >> 24);
+        default:
+            return 0;
+    }
+}
+
 std::string disassembleRv32i(unsigned int instr) {
+    if (IS_COMPRESSED(instr)) {
+        u32 expanded = expandCompressed((u16)instr);
+        return (expanded == COMPRESSED_ILLEGAL)
+                   ? "Unknown instruction!"
+                   : "c." + disassembleRv32i(expanded);
+    }
     const char *regName[] = {
         "zero", "ra", "sp", "gp", "tp",  "t0",  "t1", "t2", "s0", "s1", "a0",
         "a1",   "a2", "a3", "a4", "a5",  "a6",  "a7", "s2", "s3", "s4", "s5",
@@ -86,6 +308,57 @@ std::string disassembleRv32i(unsigned int instr) {
                     ss << "and " << regName[RD] << ", " << regName[RS1] << ", "
                        << regName[RS2];
                     break;
+                case ZEXT_H:
+                    ss << "zext.h " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case ANDN:
+                    ss << "andn " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case ORN:
+                    ss << "orn " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case XNOR:
+                    ss << "xnor " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case MIN:
+                    ss << "min " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case MINU:
+                    ss << "minu " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case MAX:
+                    ss << "max " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case MAXU:
+                    ss << "maxu " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case ROL:
+                    ss << "rol " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case ROR:
+                    ss << "ror " << regName[RD] << ", " << regName[RS1] << ", "
+                       << regName[RS2];
+                    break;
+                case SH1ADD:
+                    ss << "sh1add " << regName[RD] << ", " << regName[RS1]
+                       << ", " << regName[RS2];
+                    break;
+                case SH2ADD:
+                    ss << "sh2add " << regName[RD] << ", " << regName[RS1]
+                       << ", " << regName[RS2];
+                    break;
+                case SH3ADD:
+                    ss << "sh3add " << regName[RD] << ", " << regName[RS1]
+                       << ", " << regName[RS2];
+                    break;
                 default:
                     ss << "Unknown instruction!";
                     break;
@@ -124,18 +397,43 @@ std::string disassembleRv32i(unsigned int instr) {
         case I_JUMP:
         case I_ARITH: {
             auto immFinal = I_IMM(instr);
-            switch (FUNCT3 << 7 | OPCODE) {
-                case SLLI:
+            switch (I_ARITH_ID(instr)) {
+                case SLLI: // Shift amount is the rs2 field
                     ss << "slli " << regName[RD] << ", " << regName[RS1] << ", "
-                       << immFinal;
+                       << RS2;
                     break;
                 case SRLI:
                     ss << "srli " << regName[RD] << ", " << regName[RS1] << ", "
-                       << immFinal;
+                       << RS2;
                     break;
                 case SRAI:
                     ss << "srai " << regName[RD] << ", " << regName[RS1] << ", "
-                       << immFinal;
+                       << RS2;
+                    break;
+                case RORI:
+                    ss << "rori " << regName[RD] << ", " << regName[RS1] << ", "
+                       << RS2;
+                    break;
+                case CLZ:
+                    ss << "clz " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case CTZ:
+                    ss << "ctz " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case CPOP:
+                    ss << "cpop " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case SEXT_B:
+                    ss << "sext.b " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case SEXT_H:
+                    ss << "sext.h " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case ORC_B:
+                    ss << "orc.b " << regName[RD] << ", " << regName[RS1];
+                    break;
+                case REV8:
+                    ss << "rev8 " << regName[RD] << ", " << regName[RS1];
                     break;
                 case JALR:
                     ss << "jalr " << regName[RD] << ", " << regName[RS1] << ", "
@@ -30,11 +30,10 @@
 #define SIGINT_RET_TYPE BOOL WINAPI
 #define SIGINT_PARAM DWORD
 #define SIGINT_RET return TRUE
-#define SIGINT_REGISTER(cpu, function)                                         \
+#define SIGINT_REGISTER(function)                                              \
     do {                                                                       \
         if (!SetConsoleCtrlHandler((PHANDLER_ROUTINE)function, TRUE)) {        \
             LOG_ERROR("Error. Couldn't register sigint handler.");             \
-            cleanupSimulator(cpu);                                             \
             return ECANCELED;                                                  \
         }                                                                      \
     } while (0)
@@ -53,11 +52,10 @@
 #define SIGINT_RET                                                             \
     do {                                                                       \
     } while (0)
-#define SIGINT_REGISTER(cpu, function)                                         \
+#define SIGINT_REGISTER(function)                                              \
     do {                                                                       \
         if ((signal(SIGINT, function) == SIG_ERR)) {                           \
             LOG_ERROR("Couldn't register sigint handler.");                    \
-            cleanupSimulator(cpu);                                             \
             return ECANCELED;                                                  \
         }                                                                      \
     } while (0)
@@ -139,6 +137,23 @@ auto rev_byte_bits = [](unsigned char x) -> unsigned char {
 #define PRED(x) get_bits(x, 24, 4)
 #define FM(x) get_bits(x, 28, 4)
 
+// RV32C (16b) instructions have instr[1:0] != 2'b11
+#define IS_COMPRESSED(x) (((x)&0x3) != 0x3)
+#define COMPRESSED_ILLEGAL (0x0) // Expansion of illegal/reserved encodings
+
+// Zbb unary ops (clz, ctz, cpop, sext.b/h, orc.b, rev8) are OP-IMM shift
+// encodings selected by the full imm[11:0] (rather than just imm[11:5])
+#define IS_ZBB_UNARY(x)                                                        \
+    (OPCODE(x) == 0x13 &&                                                      \
+     ((FUNCT3(x) == 0x1 && FUNCT7(x) == 0x30) ||                               \
+      (FUNCT3(x) == 0x5 && (FUNCT7(x) == 0x14 || FUNCT7(x) == 0x34))))
+// Instruction ID of an OP-IMM instruction (shifts also key on imm[11:5])
+#define I_ARITH_ID(x)                                                          \
+    ((((FUNCT3(x) & 0x3) != 0x1)                                               \
+          ? 0                                                                  \
+          : (IS_ZBB_UNARY(x) ? IMM_11_0(x) : FUNCT7(x)) << 10) |               \
+     FUNCT3(x) << 7 | OPCODE(x))
+
 // Get immediate value from instruction (x)
 #define I_IMM(x) ((int)IMM_11_0(x) << 20) >> 20
 #define S_IMM(x) ((int)(IMM_4_0(x) | IMM_11_5(x) << 5) << 20) >> 20
@@ -158,6 +173,7 @@ auto rev_byte_bits = [](unsigned char x) -> unsigned char {
 #define KB_MULTIPLIER (1024)
 #define MB_MULTIPLIER (1024 * 1024)
 #define DEFAULT_VIRT_MEM_SIZE (KB_MULTIPLIER * 32) // Default to 32 KB
+#define STACK_TOP(memSize) (((memSize)-1) & ~0xf) // 16-byte aligned (psABI)
 #define DEFAULT_INT_PERIOD 500
 
 #define ACCESS_MEM_W(virtMem, offset) (*(u32 *)((u8 *)virtMem + offset))
@@ -216,6 +232,33 @@ enum {
     AUIPC = (0x17)
 };
 
+// Zba/Zbb instructions (unary ops are keyed on imm[11:0], see I_ARITH_ID)
+enum {
+    ANDN = (0x20 << 10) | (0x7 << 7) | (0x33),
+    ORN = (0x20 << 10) | (0x6 << 7) | (0x33),
+    XNOR = (0x20 << 10) | (0x4 << 7) | (0x33),
+    MIN = (0x05 << 10) | (0x4 << 7) | (0x33),
+    MINU = (0x05 << 10) | (0x5 << 7) | (0x33),
+    MAX = (0x05 << 10) | (0x6 << 7) | (0x33),
+    MAXU = (0x05 << 10) | (0x7 << 7) | (0x33),
+    ROL = (0x30 << 10) | (0x1 << 7) | (0x33),
+    ROR = (0x30 << 10) | (0x5 << 7) | (0x33),
+    ZEXT_H = (0x04 << 10) | (0x4 << 7) | (0x33),
+    SH1ADD = (0x10 << 10) | (0x2 << 7) | (0x33),
+    SH2ADD = (0x10 << 10) | (0x4 << 7) | (0x33),
+    SH3ADD = (0x10 << 10) | (0x6 << 7) | (0x33),
+    RORI = (0x30 << 10) | (0x5 << 7) | (0x13),
+    CLZ = (0x600 << 10) | (0x1 << 7) | (0x13),
+    CTZ = (0x601 << 10) | (0x1 << 7) | (0x13),
+    CPOP = (0x602 << 10) | (0x1 << 7) | (0x13),
+    SEXT_B = (0x604 << 10) | (0x1 << 7) | (0x13),
+    SEXT_H = (0x605 << 10) | (0x1 << 7) | (0x13),
+    ORC_B = (0x287 << 10) | (0x5 << 7) | (0x13),
+    REV8 = (0x698 << 10) | (0x5 << 7) | (0x13)
+};
+
 // Util functions
 std::string disassembleRv32i(unsigned int instr);
+u32 expandCompressed(u16 instr);
+u32 executeZb(u32 id, u32 a, u32 b);
 bool loadMem(std::string filePath, char *mem, ssize_t memLen);
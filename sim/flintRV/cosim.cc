@@ -0,0 +1,191 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "common/utils.h"
+#include "cosim.h"
+#include "risa/risa.h"
+#include "types.h"
+
+// Syscalls (taken from "riscv64-unknown-elf/include/machine/syscall.h")
+#define SYS_exit 93
+#define SYS_write 64
+
+// Syscalls/MMIO have no architectural effects to check (the harness
+// emulates them), so the reference hart's handlers are all no-ops
+static void cosimHandler(rv32iHart *cpu) { return; }
+
+risaRef::risaRef()
+    : m_hart(new rv32iHart()), m_memSize(0), m_retired(0), m_instret(0),
+      m_fastForward(false), m_halted(false) {
+    for (int i = 0; i < RISA_HANDLER_PROC_COUNT; ++i) {
+        m_hart->handlerProcs[i] = cosimHandler;
+    }
+    m_hart->handlerProcs[RISA_ENV_HANDLER_PROC] = envHandler;
+    m_hart->handlerData = this;
+}
+
+// Only emulates syscalls when fast-forwarding (i.e. not in lockstep)
+void risaRef::envHandler(rv32iHart *cpu) {
+    risaRef *ref = (risaRef *)cpu->handlerData;
+    if (!ref->m_fastForward || cpu->instFields.opcode != I_SYS) {
+        return; // FENCE
+    }
+    if (cpu->ID == EBREAK) {
+        ref->m_halted = true;
+        return;
+    }
+    switch (cpu->regFile[A7]) {
+        case SYS_exit:
+            ref->m_halted = true;
+            break;
+        case SYS_write: {
+            u32 base = cpu->regFile[A1];
+            u32 len = cpu->regFile[A2];
+            for (u32 i = 0; i < len && base + i < ref->m_memSize; ++i) {
+                printf("%c", ACCESS_MEM_B(cpu->virtMem, base + i));
+            }
+            fflush(stdout);
+            break;
+        }
+        default:
+            LOG_WARNING_PRINTF("Unknown syscall code: [ %d ]",
+                               cpu->regFile[A7]);
+            break;
+    }
+}
+
+risaRef::~risaRef() {
+    if (m_hart->virtMem != NULL) {
+        free(m_hart->virtMem);
+    }
+    delete m_hart;
+}
+
+bool risaRef::sync(const char *mem, size_t memSize, const uint32_t *regs,
+                   uint32_t pc) {
+    if (m_memSize != memSize) {
+        free(m_hart->virtMem);
+        m_hart->virtMem = (u32 *)malloc(memSize);
+        m_memSize = (m_hart->virtMem != NULL) ? memSize : 0;
+        if (m_hart->virtMem == NULL) {
+            LOG_ERROR("Could not allocate co-simulation memory.");
+            return false;
+        }
+    }
+    std::memcpy(m_hart->virtMem, mem, memSize);
+    std::memcpy(m_hart->regFile, regs, sizeof(m_hart->regFile));
+    m_hart->regFile[ZERO] = 0;
+    m_hart->virtMemSize = memSize;
+    m_hart->pc = pc;
+    m_retired = m_instret = 0;
+    m_halted = false;
+    return true;
+}
+
+bool risaRef::step(uint64_t cycle, risaRetire &retire) {
+    rv32iHart *cpu = m_hart;
+    std::memset(&retire, 0, sizeof(retire));
+    retire.cycle = cycle;
+    retire.pc = cpu->pc;
+    // Data accesses aren't bounds checked here - the RTL already made the
+    // same (checked) access before the instruction could retire
+    if (!fetchInBounds(cpu)) {
+        return false;
+    }
+    retire.instr = ACCESS_MEM_H(cpu->virtMem, cpu->pc);
+    if (!IS_COMPRESSED(retire.instr)) {
+        retire.instr = ACCESS_MEM_W(cpu->virtMem, cpu->pc);
+    }
+    if (executeInstruction(cpu) != 0) {
+        return false;
+    }
+    switch (cpu->instFields.opcode) {
+        case R:
+        case I_ARITH:
+        case I_JUMP:
+        case I_LOAD:
+        case U_AUIPC:
+        case U_LUI:
+        case J: {
+            retire.rd = cpu->instFields.rd;
+            retire.rdVal = (retire.rd != ZERO) ? cpu->regFile[retire.rd] : 0;
+            break;
+        }
+        case S: { // SB/SH/SW - funct3 is log2(bytes)
+            u32 offset = cpu->targetAddress & 0x3;
+            u32 bytes = 1 << (cpu->instFields.funct3 & 0x3);
+            u32 mask = (bytes == 4) ? 0xffffffff : (1u << (8 * bytes)) - 1;
+            retire.store = true;
+            retire.storeAddr = cpu->targetAddress & ~0x3;
+            retire.storeData = (cpu->regFile[cpu->instFields.rs2] & mask)
+                               << (8 * offset);
+            retire.storeByteEn = (((1u << bytes) - 1) << offset) & 0xf;
+            break;
+        }
+        default:
+            break;
+    }
+    cpu->pc += cpu->instrLen;
+    cpu->regFile[ZERO] = 0;
+    m_history[m_retired++ % HISTORY_LEN] = retire;
+    return true;
+}
+
+bool risaRef::fastForward(uint64_t maxInstrs, uint32_t stopPc) {
+    rv32iHart *cpu = m_hart;
+    bool ok = true;
+    m_fastForward = true;
+    for (uint64_t i = 0; i < maxInstrs && !m_halted && cpu->pc != stopPc;
+         ++i) {
+        if (!fetchInBounds(cpu)) {
+            LOG_ERROR_PRINTF("PC address [ 0x%x ] is out-of-bounds from "
+                             "memory [ 0x0 - 0x%lx ]!",
+                             cpu->pc, m_memSize);
+            ok = false;
+            break;
+        }
+        if (executeInstruction(cpu) != 0) {
+            LOG_ERROR_PRINTF("Invalid instruction at PC [ 0x%x ]!", cpu->pc);
+            ok = false;
+            break;
+        }
+        if (!m_halted) {
+            cpu->pc += cpu->instrLen;
+        }
+        cpu->regFile[ZERO] = 0;
+        m_instret++;
+    }
+    m_fastForward = false;
+    return ok;
+}
+
+uint32_t risaRef::pc() const { return m_hart->pc; }
+
+const char *risaRef::mem() const { return (const char *)m_hart->virtMem; }
+
+const uint32_t *risaRef::regs() const { return m_hart->regFile; }
+
+void risaRef::dumpHistory() const {
+    uint64_t first = (m_retired > HISTORY_LEN) ? m_retired - HISTORY_LEN : 0;
+    printf("Last retired instructions (cycle, pc, instruction, effects):\n");
+    for (uint64_t i = first; i < m_retired; ++i) {
+        const risaRetire &r = m_history[i % HISTORY_LEN];
+        printf("%12" PRIu64 " %8x:   0x%08x   %-30s", r.cycle, r.pc, r.instr,
+               disassembleRv32i(r.instr).c_str());
+        if (r.rd != ZERO) {
+            printf(" x%u <- 0x%08x", r.rd, r.rdVal);
+        }
+        if (r.store) {
+            printf(" [0x%x] <- 0x%08x (byteEn 0x%x)", r.storeAddr,
+                   r.storeData, r.storeByteEn);
+        }
+        printf("\n");
+    }
+}
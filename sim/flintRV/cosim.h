@@ -0,0 +1,59 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct rv32iHart;
+
+// Architectural effects of one instruction retired by the reference hart
+struct risaRetire {
+    uint64_t cycle; // flintRV cycle the instruction retired at
+    uint32_t pc;
+    uint32_t instr; // Fetched instruction (16b if compressed)
+    uint32_t rd;    // 0 if the regfile is not written
+    uint32_t rdVal;
+    bool store;
+    uint32_t storeAddr; // Word-aligned
+    uint32_t storeData; // Lane-shifted (i.e. as on the data bus)
+    uint32_t storeByteEn;
+};
+
+// rISA hart used as the golden reference model for lockstep co-simulation
+// (and to fast-forward programs for sampled simulation)
+class risaRef {
+  public:
+    risaRef();
+    ~risaRef();
+    // Copies the program memory/regfile state and sets the next PC to retire
+    bool sync(const char *mem, size_t memSize, const uint32_t *regs,
+              uint32_t pc);
+    // Executes the next instruction (false on invalid/out-of-bounds ones)
+    bool step(uint64_t cycle, risaRetire &retire);
+    // Executes up to maxInstrs instructions, stopping early before stopPc or
+    // when the program ends (EBREAK/exit) - false on invalid/out-of-bounds
+    // instructions. Program output (SYS_write) is printed.
+    bool fastForward(uint64_t maxInstrs, uint32_t stopPc = ~0u);
+    // Program ended on an EBREAK/exit (PC is left at it)
+    bool halted() const { return m_halted; }
+    // Instructions fast-forwarded since the last sync
+    uint64_t instret() const { return m_instret; }
+    uint32_t pc() const;
+    const char *mem() const;
+    const uint32_t *regs() const;
+    // Prints the last retired instructions (oldest first)
+    void dumpHistory() const;
+
+  private:
+    static void envHandler(rv32iHart *cpu);
+    static const int HISTORY_LEN = 8;
+    rv32iHart *m_hart;
+    size_t m_memSize;
+    risaRetire m_history[HISTORY_LEN];
+    uint64_t m_retired;
+    uint64_t m_instret;
+    bool m_fastForward; // Emulate syscalls (the harness does in lockstep)
+    bool m_halted;
+};
@@ -2,13 +2,20 @@
 // Licensed under the MIT License (see LICENSE file).
 
 #include <algorithm>
-#include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <verilated.h>
+#if VM_TRACE_FST
+#include <verilated_fst_c.h>
+#elif VM_TRACE
 #include <verilated_vcd_c.h>
+#endif // VM_TRACE_FST
+#if FLINTRV_SAVABLE
+#include <verilated_save.h>
+#endif // FLINTRV_SAVABLE
 
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
@@ -19,47 +26,120 @@
 
 #include "common/utils.h"
 
+// Trace dumper - FST or VCD, depending on how the model was Verilated
+#if VM_TRACE_FST
+class flintRVTrace : public VerilatedFstC {};
+#define TRACE_FORMAT "FST"
+#elif VM_TRACE
+class flintRVTrace : public VerilatedVcdC {};
+#define TRACE_FORMAT "VCD"
+#endif // VM_TRACE_FST
+
 flintRV::flintRV(vluint64_t maxSimTime, bool tracing)
-    : m_cpu(nullptr), m_cycles(0), m_trace(nullptr), m_maxSimTime(maxSimTime),
-      m_tracing(tracing), m_endNow(false), m_mem(nullptr), m_memSize(0) {}
+    : m_cpu(nullptr),
+#if FLINTRV_HAS_CONTEXT
+      m_context(nullptr),
+#endif
+      m_cycles(0), m_timeBase(0), m_perf(), m_perfEnabled(false),
+      m_resetPC(0), m_trace(nullptr),
+      m_traceStart(0), m_traceStop(~(vluint64_t)0), m_triggerPc(0),
+      m_triggerCycle(0), m_triggerEnabled(false), m_triggered(false),
+      m_maxSimTime(maxSimTime), m_tracing(tracing), m_quiet(false),
+      m_endNow(false), m_finished(false), m_mem(nullptr), m_memSize(0),
+      m_dirtyLo(~(size_t)0), m_dirtyHi(0), m_ref(nullptr), m_rtlStore(),
+      m_cosimSync(false), m_cosimMismatch(false) {}
 
 flintRV::~flintRV() {
-    m_cpu->final();
+    if (m_cpu != nullptr) {
+        m_cpu->final();
+    }
+#if VM_TRACE
     if (m_trace != nullptr) {
         m_trace->close();
         delete m_trace;
         m_trace = nullptr;
     }
+#endif // VM_TRACE
     if (m_cpu != nullptr) {
         delete m_cpu;
         m_cpu = nullptr;
     }
+#if FLINTRV_HAS_CONTEXT
+    if (m_context != nullptr) {
+        delete m_context;
+        m_context = nullptr;
+    }
+#endif
     if (m_mem != nullptr) {
         delete[] m_mem;
         m_mem = nullptr;
     }
+    if (m_ref != nullptr) {
+        delete m_ref;
+        m_ref = nullptr;
+    }
 }
 
-bool flintRV::create(VflintRV *cpu, const char *traceFile) {
-    if (cpu == nullptr) {
+bool flintRV::create(const char *traceFile) {
+#if FLINTRV_HAS_CONTEXT
+    m_context = new VerilatedContext;
+    m_cpu = new VflintRV(m_context);
+#else
+    m_cpu = new VflintRV();
+#endif
+    if (m_cpu == nullptr) {
         LOG_ERROR("Failed to create Verilated flintRV module!");
         return false;
     }
-    m_cpu = cpu;
     if (traceFile != nullptr) {
+#if VM_TRACE
+#if FLINTRV_HAS_CONTEXT
+        m_context->traceEverOn(true);
+#else
         Verilated::traceEverOn(true);
-        m_trace = new VerilatedVcdC;
+#endif
+        m_trace = new flintRVTrace;
         if (m_trace == nullptr) {
-            LOG_WARNING("Failed to create flintRV VCD dumper!");
+            LOG_WARNING("Failed to create flintRV " TRACE_FORMAT " dumper!");
         } else if (traceFile != nullptr) {
             m_cpu->trace(m_trace, 99);
             m_trace->open(traceFile);
         }
+#else
+        LOG_WARNING("flintRV was built without tracing, trace dump disabled!");
+#endif // VM_TRACE
     }
     reset(1); // Reset CPU on create for 1cc
+    m_resetPC = CPU(this)->startPC; // i.e. PC_START (set on the first eval)
     return true;
 }
 
+// Checks each retired instruction against a rISA reference hart (only in
+// run(), which syncs the reference to the current memory/regfile first)
+void flintRV::setCosim(bool enable) {
+    if (!enable) {
+        delete m_ref;
+        m_ref = nullptr;
+        return;
+    }
+    if (m_ref == nullptr) {
+        m_ref = new risaRef;
+    }
+    m_cosimSync = true;
+    m_cosimMismatch = false;
+}
+
+void flintRV::setTraceWindow(vluint64_t start, vluint64_t stop) {
+    m_traceStart = start;
+    m_traceStop = stop;
+}
+
+void flintRV::setTraceTrigger(vluint32_t pc) {
+    m_triggerPc = pc;
+    m_triggerEnabled = true;
+    m_triggered = false;
+}
+
 bool flintRV::createMemory(size_t memSize) {
     if (memSize == 0) {
         LOG_ERROR("Memory cannot be of size 0!");
@@ -88,6 +168,7 @@ bool flintRV::createMemory(size_t memSize, std::string initHexfile) {
     }
     std::memset(m_mem, 0, m_memSize);
     // Init mem from hexfile
+    markDirty(0, m_memSize);
     return loadMem(initHexfile, m_mem, m_memSize);
 }
 
@@ -110,7 +191,141 @@ bool flintRV::createMemory(size_t memSize, unsigned char *initHexarray,
     std::memset(m_mem, 0, m_memSize);
     // Init mem from char array
     std::memcpy(m_mem, initHexarray, initHexarrayLen);
+    markDirty(0, initHexarrayLen);
+    return true;
+}
+
+bool flintRV::reinit(unsigned char *initHexarray,
+                     unsigned int initHexarrayLen) {
+    if (m_cpu == nullptr || m_mem == nullptr) {
+        LOG_ERROR("Cannot reinit before create/createMemory!");
+        return false;
+    }
+    if (m_memSize < initHexarrayLen) {
+        LOG_ERROR("Cannot fit initialization hex char array into memory!");
+        return false;
+    }
+    // Only clear what the last program wrote
+    if (m_dirtyHi > m_dirtyLo) {
+        std::memset(&m_mem[m_dirtyLo], 0, m_dirtyHi - m_dirtyLo);
+    }
+    m_dirtyLo = ~(size_t)0;
+    m_dirtyHi = 0;
+    std::memcpy(m_mem, initHexarray, initHexarrayLen);
+    markDirty(0, initHexarrayLen);
+    // Architectural state (pipeline state is cleared by the reset below)
+    for (int i = 1; i < REGISTER_COUNT; ++i) {
+        writeRegfile(i, 0);
+    }
+    m_timeBase += m_cycles + 1;
+    m_cycles = 0;
+    m_perf = flintRVPerf();
+    m_triggered = false;
+    restartAt(m_resetPC);
+    return true;
+}
+
+// Resets the pipeline to start fetching at pc, keeping the memory/regfile
+// (e.g. architectural state handed off from rISA) and counters
+void flintRV::restartAt(vluint32_t pc) {
+    CPU(this)->startPC = pc;
+    m_endNow = m_finished = false;
+    m_cosimSync = true;
+    m_cosimMismatch = m_rtlStore.store = false;
+#if FLINTRV_HAS_CONTEXT
+    m_context->gotFinish(false);
+#else
+    Verilated::gotFinish(false);
+#endif
+    // Keep the caller's bus handshake setup across the reset
+    vluint8_t ifValid = m_cpu->i_ifValid;
+    vluint8_t memValid = m_cpu->i_memValid;
+    reset(1);
+    m_cpu->i_ifValid = ifValid;
+    m_cpu->i_memValid = memValid;
+}
+
+// Harness state saved alongside the model (w/ the memory image)
+std::vector<std::pair<void *, size_t>> flintRV::checkpointFields() {
+    return {{&m_cycles, sizeof(m_cycles)},
+            {&m_timeBase, sizeof(m_timeBase)},
+            {&m_perf, sizeof(m_perf)},
+            {&m_triggerCycle, sizeof(m_triggerCycle)},
+            {&m_triggered, sizeof(m_triggered)},
+            {&m_endNow, sizeof(m_endNow)},
+            {&m_finished, sizeof(m_finished)},
+            {&m_dirtyLo, sizeof(m_dirtyLo)},
+            {&m_dirtyHi, sizeof(m_dirtyHi)}};
+}
+
+bool flintRV::saveCheckpoint(const std::string &path) {
+#if FLINTRV_SAVABLE
+    if (m_cpu == nullptr || m_mem == nullptr) {
+        LOG_ERROR("Cannot checkpoint before create/createMemory!");
+        return false;
+    }
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        LOG_ERROR_PRINTF("Failed to open checkpoint file: %s", path.c_str());
+        return false;
+    }
+    vluint64_t memSize = m_memSize;
+    os.write(&memSize, sizeof(memSize));
+    for (auto &field : checkpointFields()) {
+        os.write(field.first, field.second);
+    }
+    os.write(m_mem, m_memSize);
+    os << *m_cpu;
+    os.close();
+    return true;
+#else
+    LOG_ERROR_PRINTF("Cannot save %s, flintRV was built without "
+                     "-DVERILATOR_SAVABLE=ON!",
+                     path.c_str());
+    return false;
+#endif // FLINTRV_SAVABLE
+}
+
+// Restores a checkpoint saved by the same build (i.e. same core config)
+bool flintRV::restoreCheckpoint(const std::string &path) {
+#if FLINTRV_SAVABLE
+    if (m_cpu == nullptr) {
+        LOG_ERROR("Cannot restore a checkpoint before create!");
+        return false;
+    }
+    VerilatedRestore os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        LOG_ERROR_PRINTF("Failed to open checkpoint file: %s", path.c_str());
+        return false;
+    }
+    vluint64_t memSize = 0;
+    os.read(&memSize, sizeof(memSize));
+    if (m_mem == nullptr && !createMemory(memSize)) {
+        return false;
+    }
+    if (memSize != m_memSize) {
+        LOG_ERROR_PRINTF("Checkpoint memory size (0x%" PRIx64
+                         ") does not match the harness memory (0x%lx)!",
+                         (uint64_t)memSize, m_memSize);
+        return false;
+    }
+    for (auto &field : checkpointFields()) {
+        os.read(field.first, field.second);
+    }
+    os.read(m_mem, m_memSize);
+    os >> *m_cpu;
+    os.close();
+    m_cosimSync = true;
+    m_cosimMismatch = m_rtlStore.store = false;
     return true;
+#else
+    LOG_ERROR_PRINTF("Cannot restore %s, flintRV was built without "
+                     "-DVERILATOR_SAVABLE=ON!",
+                     path.c_str());
+    return false;
+#endif // FLINTRV_SAVABLE
 }
 
 bool flintRV::instructionUpdate() {
@@ -119,7 +334,12 @@ bool flintRV::instructionUpdate() {
         LOG_ERROR("Cannot fetch instruction from NULL memory!");
         return false;
     }
-    if (m_cpu->o_pcOut >= m_memSize) {
+    // Compressed (RV32C) instructions only need 2 bytes, i.e. may sit in the
+    // last halfword of memory
+    size_t pc = m_cpu->o_pcOut;
+    size_t avail = (pc < m_memSize) ? m_memSize - pc : 0;
+    bool isC = (avail >= sizeof(u16)) && ((m_mem[pc] & 0x3) != 0x3);
+    if (avail < (isC ? sizeof(u16) : sizeof(u32))) {
         LOG_ERROR_PRINTF(
             "PC address [ 0x%x ] is out-of-bounds from memory [ 0x0 - 0x%lx "
             "]!",
@@ -127,7 +347,17 @@ bool flintRV::instructionUpdate() {
         return false;
     }
     // Fetch the next instruction
-    m_cpu->i_instr = *(int *)&m_mem[m_cpu->o_pcOut];
+    if (avail >= sizeof(u32)) {
+        m_cpu->i_instr = *(int *)&m_mem[pc];
+    } else {
+        u16 half = 0;
+        std::memcpy(&half, &m_mem[pc], sizeof(half));
+        m_cpu->i_instr = half;
+    }
+    if (m_triggerEnabled && !m_triggered && m_cpu->o_pcOut == m_triggerPc) {
+        m_triggered = true;
+        m_triggerCycle = m_cycles;
+    }
 
     if (CPU(this)->p_ebreak[CPU(this)->EXEC] && !CPU(this)->pcJump) {
         // flintRV simulator treats EBREAK as the quit/exit signal
@@ -148,8 +378,10 @@ bool flintRV::instructionUpdate() {
                     if (!peekMem(address + i, value)) {
                         return false;
                     }
-                    printf("%c", (char)value);
-                    fflush(stdout);
+                    if (!m_quiet) {
+                        printf("%c", (char)value);
+                        fflush(stdout);
+                    }
                 }
                 break;
             }
@@ -171,7 +403,20 @@ bool flintRV::loadStoreUpdate() {
         LOG_ERROR("Cannot loadStoreUpdate on NULL memory!");
         return false;
     }
-    if (m_cpu->o_dataAddr >= m_memSize) {
+    // The core only lane-shifts naturally aligned accesses (a misaligned one
+    // would be silently folded into the aligned word)
+    auto core = CPU(this);
+    vluint32_t size = 1u << (core->p_funct3[core->MEM] & 0x3);
+    if (m_cpu->o_dataAddr & (size - 1)) {
+        LOG_ERROR_PRINTF("Misaligned %u-byte %s at address [ 0x%x ] (PC: "
+                         "0x%x) is not supported!",
+                         size, m_cpu->o_loadReq ? "load" : "store",
+                         m_cpu->o_dataAddr, core->p_PC[core->MEM]);
+        return false;
+    }
+    // Memory is accessed as aligned words (core lane-shifts data)
+    size_t wordAddr = m_cpu->o_dataAddr & ~0x3;
+    if (wordAddr + 4 > m_memSize) {
         LOG_ERROR_PRINTF(
             "Address [ 0x%x ] is out-of-bounds from memory [ 0x0 - 0x%lx ]!",
             m_cpu->o_dataAddr, m_memSize);
@@ -179,17 +424,18 @@ bool flintRV::loadStoreUpdate() {
     }
 
     if (m_cpu->o_loadReq) { // Load
-        m_cpu->i_dataIn = *(int *)&m_mem[m_cpu->o_dataAddr];
-    } else { // Store
-        if (CPU(this)->p_funct3[CPU(this)->MEM] == CPU(this)->S_B_OP) {
-            *(int *)&m_mem[m_cpu->o_dataAddr] &= 0xffffff00;
-            *(int *)&m_mem[m_cpu->o_dataAddr] |= m_cpu->o_dataOut;
-        } else if (CPU(this)->p_funct3[CPU(this)->MEM] == CPU(this)->S_H_OP) {
-            *(int *)&m_mem[m_cpu->o_dataAddr] &= 0xffff0000;
-            *(int *)&m_mem[m_cpu->o_dataAddr] |= m_cpu->o_dataOut;
-        } else {
-            *(int *)&m_mem[m_cpu->o_dataAddr] = m_cpu->o_dataOut;
+        m_cpu->i_dataIn = *(int *)&m_mem[wordAddr];
+    } else { // Store (byte-strobed)
+        markDirty(wordAddr, wordAddr + 4);
+        for (int i = 0; i < 4; ++i) {
+            if (m_cpu->o_byteEn & (1 << i)) {
+                m_mem[wordAddr + i] = (char)(m_cpu->o_dataOut >> (8 * i));
+            }
         }
+        m_rtlStore.store = true;
+        m_rtlStore.storeAddr = wordAddr;
+        m_rtlStore.storeData = m_cpu->o_dataOut;
+        m_rtlStore.storeByteEn = m_cpu->o_byteEn;
     }
     return true;
 }
@@ -207,7 +453,9 @@ bool flintRV::peekMem(size_t addr, int &val) {
             addr, m_memSize);
         return false;
     }
-    val = *(int *)&m_mem[addr];
+    // Partial word at the end of memory (upper bytes read as 0)
+    val = 0;
+    std::memcpy(&val, &m_mem[addr], std::min(sizeof(int), m_memSize - addr));
     return true;
 }
 
@@ -224,7 +472,9 @@ bool flintRV::pokeMem(size_t addr, int val) {
             addr, m_memSize);
         return false;
     }
-    *(int *)&m_mem[addr] = val;
+    size_t len = std::min(sizeof(int), m_memSize - addr);
+    std::memcpy(&m_mem[addr], &val, len);
+    markDirty(addr, addr + len);
     return true;
 }
 
@@ -258,23 +508,143 @@ void flintRV::reset(int cycles) {
 }
 
 void flintRV::tick(bool enableDump) {
-    static std::atomic<vluint64_t> global_time{0};
+#if VM_TRACE
+    // Only dump within the trace window (timestamps are 2x the cycle count)
+    bool traceNow = (m_trace != nullptr) && (m_cycles >= m_traceStart) &&
+                    (m_cycles < m_traceStop);
+#endif // VM_TRACE
     if (enableDump) {
         dump();
     }
     m_cpu->i_clk = 0;
     m_cpu->eval();
-    if (m_trace) {
-        m_trace->dump(global_time++);
+#if VM_TRACE
+    if (traceNow) {
+        m_trace->dump(2 * (m_timeBase + m_cycles));
+    }
+#endif // VM_TRACE
+    if (m_perfEnabled && !m_cpu->i_rst) {
+        samplePerf();
     }
     m_cpu->i_clk = 1;
     m_cpu->eval();
-    if (m_trace) {
-        m_trace->dump(global_time++);
+#if VM_TRACE
+    if (traceNow) {
+        m_trace->dump(2 * (m_timeBase + m_cycles) + 1);
     }
+#endif // VM_TRACE
     m_cycles++;
 }
 
+void flintRV::samplePerf() {
+    auto core = CPU(this);
+    m_perf.cycles++;
+    m_perf.retired += core->p_valid[core->WB];
+    // Branch prediction stats (sampled at resolution)
+    m_perf.branches += core->ctrlResolve;
+    m_perf.mispredicts += core->mispredict;
+    if (core->pcJump) { // Fetch, decode (and EXEC if resolved in MEM)
+        m_perf.flushedSlots += m_cpu->i_ifValid + core->validReg +
+                               (core->MEM_flush ? core->p_valid[core->EXEC]
+                                                : 0);
+    }
+    // Lost cycles - one cause per cycle, in stall priority order
+    if (core->MEM_stall) {
+        m_perf.loadWaitStalls += core->load_wait;
+        m_perf.storeWaitStalls += core->store_wait;
+    } else if (core->MULDIV_stall) {
+        m_perf.mulDivStalls++;
+    } else {
+        // Load-use stats (counted once per decoded instruction)
+        m_perf.loadUses += core->loadUse;
+        if (core->load_hazard) {
+            m_perf.loadUseStalls++;
+        } else if (core->FETCH_stall) { // i.e. ~i_ifValid
+            m_perf.fetchStalls++;
+        }
+    }
+}
+
+// Lost cycles not caused by stalls/flushes (i.e. pipeline fill/drain)
+static vluint64_t otherLostCycles(const flintRVPerf &p) {
+    vluint64_t attributed = p.retired + p.loadUseStalls + p.loadWaitStalls +
+                            p.storeWaitStalls + p.mulDivStalls +
+                            p.fetchStalls + p.flushedSlots;
+    return (p.cycles > attributed) ? p.cycles - attributed : 0;
+}
+
+void flintRV::printPerf() const {
+    if (!m_perfEnabled) {
+        LOG_INFO("Performance counters were disabled.");
+        return;
+    }
+    const flintRVPerf &p = m_perf;
+    double cycles = (p.cycles > 0) ? (double)p.cycles : 1.0;
+    LOG_INFO_PRINTF("Retired: %" PRIu64 ", CPI: %.3f, load-use hazards: "
+                    "%" PRIu64 ".",
+                    (uint64_t)p.retired,
+                    (p.retired > 0) ? p.cycles / (double)p.retired : 0.0,
+                    (uint64_t)p.loadUses);
+    const std::pair<const char *, vluint64_t> lost[] = {
+        {"load-use stalls", p.loadUseStalls},
+        {"load wait stalls", p.loadWaitStalls},
+        {"store wait stalls", p.storeWaitStalls},
+        {"mul/div stalls", p.mulDivStalls},
+        {"fetch stalls", p.fetchStalls},
+        {"redirect flushes", p.flushedSlots},
+        {"fill/drain/other", otherLostCycles(p)}};
+    LOG_INFO("Lost cycles by cause:");
+    for (const auto &cause : lost) {
+        printf("    %-20s %14" PRIu64 " (%5.1f%%)\n", cause.first,
+               (uint64_t)cause.second, 100.0 * cause.second / cycles);
+    }
+}
+
+bool flintRV::writePerfJson(const std::string &path) const {
+    FILE *f = fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        LOG_ERROR_PRINTF("Failed to open perf counter file: %s", path.c_str());
+        return false;
+    }
+    if (!m_perfEnabled) {
+        LOG_WARNING_PRINTF("Performance counters were disabled, %s has no "
+                           "counters.",
+                           path.c_str());
+        fprintf(f, "{\n    \"enabled\": false\n}\n");
+        fclose(f);
+        return true;
+    }
+    const flintRVPerf &p = m_perf;
+    fprintf(f,
+            "{\n"
+            "    \"enabled\": true,\n"
+            "    \"cycles\": %" PRIu64 ",\n"
+            "    \"retired\": %" PRIu64 ",\n"
+            "    \"cpi\": %.6f,\n"
+            "    \"branches\": %" PRIu64 ",\n"
+            "    \"mispredicts\": %" PRIu64 ",\n"
+            "    \"loadUses\": %" PRIu64 ",\n"
+            "    \"lostCycles\": {\n"
+            "        \"loadUseStalls\": %" PRIu64 ",\n"
+            "        \"loadWaitStalls\": %" PRIu64 ",\n"
+            "        \"storeWaitStalls\": %" PRIu64 ",\n"
+            "        \"mulDivStalls\": %" PRIu64 ",\n"
+            "        \"fetchStalls\": %" PRIu64 ",\n"
+            "        \"flushedSlots\": %" PRIu64 ",\n"
+            "        \"other\": %" PRIu64 "\n"
+            "    }\n"
+            "}\n",
+            (uint64_t)p.cycles, (uint64_t)p.retired,
+            (p.retired > 0) ? p.cycles / (double)p.retired : 0.0,
+            (uint64_t)p.branches, (uint64_t)p.mispredicts,
+            (uint64_t)p.loadUses, (uint64_t)p.loadUseStalls,
+            (uint64_t)p.loadWaitStalls, (uint64_t)p.storeWaitStalls,
+            (uint64_t)p.mulDivStalls, (uint64_t)p.fetchStalls,
+            (uint64_t)p.flushedSlots, (uint64_t)otherLostCycles(p));
+    fclose(f);
+    return true;
+}
+
 void flintRV::dump() {
     if (m_tracing) {
         std::string instr =
@@ -284,13 +654,172 @@ void flintRV::dump() {
     }
 }
 
+bool flintRV::gotFinish() const {
+#if FLINTRV_HAS_CONTEXT
+    return m_context->gotFinish();
+#else
+    return Verilated::gotFinish();
+#endif
+}
+
 bool flintRV::end() {
-    bool isFinished =
-        Verilated::gotFinish() || m_cycles > m_maxSimTime || m_endNow;
+    if (m_finished) {
+        return true;
+    }
+    bool isFinished = gotFinish() || m_cycles > m_maxSimTime || m_endNow;
     if (isFinished) {
         // Need to finish draining pipeline here...
         loadStoreUpdate();
         tick(false);
+        if (m_ref != nullptr) {
+            cosimRetire(); // Mismatches are returned by run()
+        }
+        m_finished = true;
     }
     return isFinished;
 }
+
+// Runs for up to maxCycles or until the simulation ends (false on faults)
+bool flintRV::run(vluint64_t maxCycles) {
+    if (m_mem == nullptr) {
+        LOG_ERROR("Cannot run from NULL memory!");
+        return false;
+    }
+    if (m_ref != nullptr && m_cosimSync && !cosimSync()) {
+        return false;
+    }
+    auto core = CPU(this);
+    vluint64_t stopCycle = m_cycles + std::min(maxCycles, ~m_cycles);
+    while (m_cycles < stopCycle && !end()) {
+        // Fetch - ECALL/EBREAK, trace triggers and fetches near the end of
+        // memory take the checked path
+        if (core->p_ebreak[core->EXEC] || core->p_ecall[core->WB] ||
+            m_triggerEnabled ||
+            (size_t)m_cpu->o_pcOut + sizeof(int) > m_memSize) {
+            if (!instructionUpdate()) {
+                return false;
+            }
+        } else {
+            m_cpu->i_instr = *(int *)&m_mem[m_cpu->o_pcOut];
+        }
+        // Load/store
+        if ((m_cpu->o_loadReq || m_cpu->o_storeReq) && !loadStoreUpdate()) {
+            return false;
+        }
+        tick(m_tracing);
+        if (m_ref != nullptr && !cosimRetire()) {
+            return false;
+        }
+    }
+    return !m_cosimMismatch;
+}
+
+// Syncs the reference to the (possibly mid-flight, e.g. restored) pipeline
+bool flintRV::cosimSync() {
+    auto core = CPU(this);
+    uint32_t regs[REGISTER_COUNT];
+    for (int i = 0; i < REGISTER_COUNT; ++i) {
+        regs[i] = readRegfile(i);
+    }
+    // WB writes back on the next tick w/o being checked
+    if (core->p_valid[core->WB] && core->p_reg_w[core->WB]) {
+        regs[core->p_rdAddr[core->WB]] = core->p_mem2reg[core->WB]
+                                             ? core->p_readData[core->WB]
+                                             : core->p_aluOut[core->WB];
+    }
+    // Resume at the oldest instruction still to retire
+    uint32_t pc = core->p_valid[core->MEM]    ? core->p_PC[core->MEM]
+                  : core->p_valid[core->EXEC] ? core->p_PC[core->EXEC]
+                  : core->validReg            ? core->PCReg
+                                              : m_cpu->o_pcOut;
+    m_rtlStore.store = false;
+    m_cosimSync = false;
+    return m_ref->sync(m_mem, m_memSize, regs, pc);
+}
+
+static void printRetire(const char *model, const risaRetire &r, bool full) {
+    printf("%s: pc 0x%x", model, r.pc);
+    if (full) {
+        if (r.rd != ZERO) {
+            printf(", x%u <- 0x%08x", r.rd, r.rdVal);
+        } else {
+            printf(", no rd write");
+        }
+        if (r.store) {
+            printf(", [0x%x] <- 0x%08x (byteEn 0x%x)", r.storeAddr,
+                   r.storeData, r.storeByteEn);
+        } else {
+            printf(", no store");
+        }
+    }
+    printf("\n");
+}
+
+// Steps the reference hart for the instruction retiring at WB (if any) and
+// compares its PC, rd write and store - stops at the first mismatch
+bool flintRV::cosimRetire() {
+    auto core = CPU(this);
+    if (m_cosimMismatch || !core->p_valid[core->WB]) {
+        return !m_cosimMismatch;
+    }
+    risaRetire rtl = m_rtlStore;
+    rtl.pc = core->p_PC[core->WB];
+    if (core->p_reg_w[core->WB]) { // i.e. WB_result
+        rtl.rd = core->p_rdAddr[core->WB];
+        rtl.rdVal = core->p_mem2reg[core->WB] ? core->p_readData[core->WB]
+                                              : core->p_aluOut[core->WB];
+    }
+    m_rtlStore.store = false;
+
+    risaRetire ref = {};
+    ref.pc = m_ref->pc();
+    const char *mismatch = nullptr;
+    u32 lanes = 0;
+    if (rtl.pc != ref.pc) {
+        mismatch = "PC";
+    } else if (!m_ref->step(m_cycles, ref)) {
+        mismatch = "invalid instruction on the reference";
+    } else if (rtl.rd != ref.rd || rtl.rdVal != ref.rdVal) {
+        mismatch = "rd write";
+    } else if (rtl.store != ref.store) {
+        mismatch = "memory write";
+    } else if (rtl.store) {
+        for (int i = 0; i < 4; ++i) {
+            lanes |= (ref.storeByteEn & (1 << i)) ? (0xffu << (8 * i)) : 0;
+        }
+        if (rtl.storeAddr != ref.storeAddr ||
+            rtl.storeByteEn != ref.storeByteEn ||
+            ((rtl.storeData ^ ref.storeData) & lanes) != 0) {
+            mismatch = "memory write";
+        }
+    }
+    if (mismatch == nullptr) {
+        return true;
+    }
+    m_cosimMismatch = true;
+    LOG_ERROR_PRINTF("Co-simulation mismatch ( %s ) at cycle %" PRIu64 "!",
+                     mismatch, (uint64_t)m_cycles);
+    m_ref->dumpHistory();
+    bool stepped = rtl.pc == ref.pc;
+    printRetire("RTL", rtl, stepped);
+    printRetire("ref", ref, stepped);
+    return false;
+}
+
+flintRV *flintRVPool::acquire(size_t memSize, unsigned char *initHexarray,
+                              unsigned int initHexarrayLen,
+                              vluint64_t maxSimTime, bool tracing) {
+    auto it = m_harnesses.find(memSize);
+    if (it != m_harnesses.end()) {
+        flintRV *dut = it->second.get();
+        dut->setMaxSimTime(maxSimTime);
+        dut->setTracing(tracing);
+        return dut->reinit(initHexarray, initHexarrayLen) ? dut : nullptr;
+    }
+    std::unique_ptr<flintRV> dut(new flintRV(maxSimTime, tracing));
+    if (!dut->create() ||
+        !dut->createMemory(memSize, initHexarray, initHexarrayLen)) {
+        return nullptr;
+    }
+    return (m_harnesses[memSize] = std::move(dut)).get();
+}
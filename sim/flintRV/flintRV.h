@@ -3,21 +3,44 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdio>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "VflintRV.h"
 #include "VflintRV__Syms.h"
 
+#include "cosim.h"
+
+// Normally set by CMake (major * 1000 + minor), otherwise taken from
+// verilated_config.h (if defined there) or assumed to be v4.028
 #ifndef VERILATOR_VER
+#ifdef VERILATOR_VERSION_INTEGER
+#define VERILATOR_VER (VERILATOR_VERSION_INTEGER / 1000)
+#else
 #define VERILATOR_VER 4028
+#endif // VERILATOR_VERSION_INTEGER
 #endif // VERILATOR_VER
 
+// Verilator v4.202+ models each get their own VerilatedContext (i.e. time,
+// finish and trace state), so separate instances can run on separate threads
+#if VERILATOR_VER >= 4202
+#define FLINTRV_HAS_CONTEXT 1
+#else
+#define FLINTRV_HAS_CONTEXT 0
+#endif
+
 #ifndef flintRV_VERSION
 #define flintRV_VERSION "unknown"
 #endif // flintRV_VERSION
 
+// VCD/FST dumper (only defined when the model is Verilated w/ tracing)
+class flintRVTrace;
+
 // Syscalls (taken from "riscv64-unknown-elf/include/machine/syscall.h")
 #define SYS_exit 93
 #define SYS_write 64
@@ -60,15 +83,43 @@ typedef enum {
     REGISTER_COUNT
 } RV32I_Registers;
 
+// Pipeline performance counters (sampled every cycle outside of reset, when
+// enabled w/ setPerf())
+struct flintRVPerf {
+    vluint64_t cycles;
+    vluint64_t retired;     // Instructions retired at WB
+    vluint64_t branches;    // Resolved branches/jumps
+    vluint64_t mispredicts; // Resolved branches/jumps that redirected fetch
+    vluint64_t loadUses;    // Loads immediately followed by a dependent
+    // Lost cycles (i.e. WB bubbles) by cause - the rest is pipeline fill/drain
+    vluint64_t loadUseStalls;   // Bubbles inserted for load-use hazards
+    vluint64_t loadWaitStalls;  // Waiting on load data (i_memValid)
+    vluint64_t storeWaitStalls; // Waiting on store completion (i_memValid)
+    vluint64_t mulDivStalls;    // Waiting on the multiply/divide unit
+    vluint64_t fetchStalls;     // Waiting on instruction fetch (i_ifValid)
+    vluint64_t flushedSlots;    // Instructions squashed by fetch redirects
+};
+
 class flintRV {
   public:
     flintRV(vluint64_t maxSimTime, bool tracing = false);
     ~flintRV();
-    bool create(VflintRV *cpu, const char *traceFile = nullptr);
+    bool create(const char *traceFile = nullptr);
+    void setTraceWindow(vluint64_t start, vluint64_t stop);
+    void setTraceTrigger(vluint32_t pc);
     bool createMemory(size_t memSize);
     bool createMemory(size_t memSize, std::string initHexfile);
     bool createMemory(size_t memSize, unsigned char *initHexarray,
                       unsigned int initHexarrayLen);
+    bool reinit(unsigned char *initHexarray, unsigned int initHexarrayLen);
+    void restartAt(vluint32_t pc);
+    void setMaxSimTime(vluint64_t maxSimTime) { m_maxSimTime = maxSimTime; }
+    void setTracing(bool tracing) { m_tracing = tracing; }
+    void setQuiet(bool quiet) { m_quiet = quiet; }
+    void setPerf(bool enable) { m_perfEnabled = enable; }
+    void setCosim(bool enable);
+    bool saveCheckpoint(const std::string &path);
+    bool restoreCheckpoint(const std::string &path);
     bool instructionUpdate();
     bool loadStoreUpdate();
     bool peekMem(size_t addr, int &val);
@@ -79,16 +130,67 @@ class flintRV {
     void tick(bool enableDump = true);
     void dump();
     bool end();
+    bool gotFinish() const;
+    bool run(vluint64_t maxCycles);
+    vluint64_t cycles() const { return m_cycles; }
+    size_t memSize() const { return m_memSize; }
+    const flintRVPerf &perf() const { return m_perf; }
+    bool perfEnabled() const { return m_perfEnabled; }
+    void printPerf() const;
+    bool writePerfJson(const std::string &path) const;
+    bool triggered() const { return m_triggered; }
+    vluint64_t triggerCycle() const { return m_triggerCycle; }
+    bool cosimMismatch() const { return m_cosimMismatch; }
     VflintRV *m_cpu; // Reference to CPU object
 
   private:
+    void markDirty(size_t lo, size_t hi) {
+        m_dirtyLo = std::min(m_dirtyLo, lo);
+        m_dirtyHi = std::max(m_dirtyHi, hi);
+    }
+    std::vector<std::pair<void *, size_t>> checkpointFields();
+    void samplePerf();
+    bool cosimSync();
+    bool cosimRetire();
+#if FLINTRV_HAS_CONTEXT
+    VerilatedContext *m_context; // Owns m_cpu's simulation state
+#endif
     vluint64_t m_cycles;
-    VerilatedVcdC *m_trace;
+    vluint64_t m_timeBase; // Trace time of cycle 0 (advances on reinit)
+    flintRVPerf m_perf;
+    bool m_perfEnabled; // Off by default (reads ~15 model internals per cycle)
+    vluint32_t m_resetPC; // PC_START (restartAt() moves the reset vector)
+    flintRVTrace *m_trace;
+    vluint64_t m_traceStart; // Trace dump window [start, stop) in cycles
+    vluint64_t m_traceStop;
+    vluint32_t m_triggerPc;     // Fetch PC that fires the trace trigger
+    vluint64_t m_triggerCycle;  // Cycle of the first trigger PC fetch
+    bool m_triggerEnabled;
+    bool m_triggered;
     vluint64_t m_maxSimTime;
     bool m_tracing;
+    bool m_quiet; // Drop the program's SYS_write output
     bool m_endNow;
+    bool m_finished; // Pipeline drained (see end())
     char *m_mem;      // Test memory
     size_t m_memSize; // Sizeof Test memory in bytes
+    size_t m_dirtyLo; // Written memory range [lo, hi) (cleared on reinit)
+    size_t m_dirtyHi;
+    risaRef *m_ref;        // Lockstep reference hart (co-simulation)
+    risaRetire m_rtlStore; // Last store issued from MEM (checked at WB)
+    bool m_cosimSync;      // Re-sync the reference before the next run
+    bool m_cosimMismatch;
+};
+
+// Reusable harnesses (e.g. one pool per test worker) - reinit'd per program
+class flintRVPool {
+  public:
+    flintRV *acquire(size_t memSize, unsigned char *initHexarray,
+                     unsigned int initHexarrayLen, vluint64_t maxSimTime,
+                     bool tracing = false);
+
+  private:
+    std::map<size_t, std::unique_ptr<flintRV>> m_harnesses; // By memSize
 };
 
 /*
@@ -0,0 +1,392 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "common/utils.h"
+#include "fuzz.h"
+
+#define FUZZ_NOP 0x00000013     // addi zero, zero, 0
+#define FUZZ_TAIL_NOPS 8        // Longest forward branch/jump (in instrs)
+#define FUZZ_MAX_LOOP_BODY 16   // Loop body instrs
+#define FUZZ_MAX_LOOP_COUNT 4   // Loop iterations
+#define FUZZ_MAX_CYCLES 1000000 // RTL cycles (and rISA instrs) per program
+#define FUZZ_LOOP_REG T5        // Only written by loop setup/close
+#define FUZZ_DATA_REG T6        // Data region base (never written)
+
+static_assert(FUZZ_MAX_INSTRS * 4 <= FUZZ_DATA_BASE,
+              "Fuzz code does not fit below the data region");
+static_assert(FUZZ_DATA_BASE + FUZZ_DATA_SIZE <= FUZZ_MEM_SIZE,
+              "Fuzz data region does not fit in memory");
+
+namespace {
+// Fuzzer input reader (reads 0s once exhausted)
+class fuzzBytes {
+  public:
+    fuzzBytes(const uint8_t *data, size_t len)
+        : m_data(data), m_len(len), m_pos(0) {}
+    bool empty() const { return m_pos >= m_len; }
+    uint32_t byte() { return empty() ? 0 : m_data[m_pos++]; }
+    uint32_t below(uint32_t n) { return byte() % n; }
+    uint32_t word() {
+        uint32_t w = 0;
+        for (int i = 0; i < 4; ++i) {
+            w |= byte() << (8 * i);
+        }
+        return w;
+    }
+
+  private:
+    const uint8_t *m_data;
+    size_t m_len;
+    size_t m_pos;
+};
+
+// Encoders - id is an instruction ID (funct7 << 10 | funct3 << 7 | opcode)
+uint32_t encR(uint32_t id, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return (id >> 10) << 25 | rs2 << 20 | rs1 << 15 | ((id >> 7) & 0x7) << 12 |
+           rd << 7 | (id & 0x7f);
+}
+
+uint32_t encI(uint32_t id, uint32_t rd, uint32_t rs1, int32_t imm) {
+    return ((uint32_t)imm & 0xfff) << 20 | rs1 << 15 |
+           ((id >> 7) & 0x7) << 12 | rd << 7 | (id & 0x7f);
+}
+
+uint32_t encS(uint32_t id, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return ((u >> 5) & 0x7f) << 25 | rs2 << 20 | rs1 << 15 |
+           ((id >> 7) & 0x7) << 12 | (u & 0x1f) << 7 | (id & 0x7f);
+}
+
+uint32_t encB(uint32_t id, uint32_t rs1, uint32_t rs2, int32_t off) {
+    uint32_t u = (uint32_t)off;
+    return ((u >> 12) & 0x1) << 31 | ((u >> 5) & 0x3f) << 25 | rs2 << 20 |
+           rs1 << 15 | ((id >> 7) & 0x7) << 12 | ((u >> 1) & 0xf) << 8 |
+           ((u >> 11) & 0x1) << 7 | (id & 0x7f);
+}
+
+uint32_t encU(uint32_t id, uint32_t rd, uint32_t imm20) {
+    return (imm20 & 0xfffff) << 12 | rd << 7 | (id & 0x7f);
+}
+
+uint32_t encJ(uint32_t rd, int32_t off) {
+    uint32_t u = (uint32_t)off;
+    return ((u >> 20) & 0x1) << 31 | ((u >> 1) & 0x3ff) << 21 |
+           ((u >> 11) & 0x1) << 20 | ((u >> 12) & 0xff) << 12 | rd << 7 | JAL;
+}
+
+void appendf(std::string &s, const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    s += buf;
+}
+
+const uint32_t aluOps[] = {ADD, SUB, SLL, SLT, SLTU, XOR, SRL, SRA, OR, AND};
+const uint32_t aluImmOps[] = {ADDI, SLTI, SLTIU, XORI, ORI, ANDI};
+const uint32_t shiftImmOps[] = {SLLI, SRLI, SRAI};
+const uint32_t loadOps[] = {LB, LH, LW, LBU, LHU};
+const uint32_t storeOps[] = {SB, SH, SW};
+const uint32_t branchOps[] = {BEQ, BNE, BLT, BGE, BLTU, BGEU};
+#define FUZZ_COUNT(a) (sizeof(a) / sizeof(a[0]))
+
+// Access size of a load/store ID (funct3[1:0] is log2(bytes))
+uint32_t accessSize(uint32_t id) { return 1u << ((id >> 7) & 0x3); }
+} // namespace
+
+flintRVFuzzProgram fuzzGenerate(const uint8_t *data, size_t len) {
+    fuzzBytes in(data, len);
+    flintRVFuzzProgram prog;
+    std::vector<uint32_t> &code = prog.code;
+
+    // Initial state (PRNG-filled, leaving the input bytes to the code)
+    std::mt19937 rng(in.word());
+    prog.regs[ZERO] = 0;
+    for (int i = 1; i < REGISTER_COUNT; ++i) {
+        // Mix of small values (i.e. equal compares) and full-width ones
+        prog.regs[i] = (rng() & 1) ? rng() : rng() % 4;
+    }
+    prog.regs[FUZZ_LOOP_REG] = 0;
+    prog.regs[FUZZ_DATA_REG] = FUZZ_DATA_BASE;
+    for (uint8_t &b : prog.data) {
+        b = (uint8_t)rng();
+    }
+
+    uint32_t recent[3] = {ZERO, ZERO, ZERO}; // Last written rd's
+    auto dest = [&](bool allowZero) {
+        uint32_t rd = ZERO;
+        if (!allowZero || in.below(8) != 0) {
+            rd = 1 + in.below(T4); // x1-x29 (x30/x31 are reserved)
+        }
+        recent[2] = recent[1];
+        recent[1] = recent[0];
+        recent[0] = rd;
+        return rd;
+    };
+    // Sources are biased towards the last results (i.e. forwarding paths)
+    auto src = [&]() {
+        return in.below(2) ? recent[in.below(3)] : in.below(REGISTER_COUNT);
+    };
+    auto imm12 = [&]() {
+        return in.below(2) ? (int32_t)(in.word() << 20) >> 20
+                           : (int32_t)in.below(32) - 16;
+    };
+    auto loadStoreOff = [&](uint32_t id) {
+        uint32_t size = accessSize(id);
+        return (int32_t)(size * in.below(FUZZ_DATA_SIZE / size));
+    };
+    // Forward branches/jumps land within FUZZ_TAIL_NOPS, but never on an
+    // instruction that depends on the one before it (patched below)
+    std::vector<size_t> edges;
+    std::vector<bool> noLand;
+    auto emit = [&](uint32_t instr, bool landable) {
+        code.push_back(instr);
+        noLand.push_back(!landable);
+    };
+    auto forwardOff = [&]() {
+        return (int32_t)(4 * (1 + in.below(FUZZ_TAIL_NOPS)));
+    };
+
+    int loopStart = -1; // First body instruction of the open loop
+    auto closeLoop = [&]() {
+        emit(encI(ADDI, FUZZ_LOOP_REG, FUZZ_LOOP_REG, -1), true);
+        int32_t off = (loopStart - (int)code.size()) * 4;
+        // Skipping the decrement could loop forever
+        emit(encB(BLT, ZERO, FUZZ_LOOP_REG, off), false);
+        loopStart = -1;
+    };
+
+    while (!in.empty() &&
+           code.size() + 4 + FUZZ_TAIL_NOPS + 1 <= FUZZ_MAX_INSTRS) {
+        uint32_t kind = in.below(16);
+        if (loopStart >= 0 &&
+            (kind == 15 ||
+             code.size() - (size_t)loopStart >= FUZZ_MAX_LOOP_BODY)) {
+            closeLoop();
+            continue;
+        }
+        switch (kind) {
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+            case 4: { // Register-register ALU
+                uint32_t id = aluOps[in.below(FUZZ_COUNT(aluOps))];
+                uint32_t rs1 = src();
+                uint32_t rs2 = src();
+                emit(encR(id, dest(true), rs1, rs2), true);
+                break;
+            }
+            case 5:
+            case 6: { // Register-immediate ALU
+                uint32_t id = aluImmOps[in.below(FUZZ_COUNT(aluImmOps))];
+                uint32_t rs1 = src();
+                int32_t imm = imm12();
+                emit(encI(id, dest(true), rs1, imm), true);
+                break;
+            }
+            case 7: { // Shift by immediate (SRAI's funct7 is in imm[11:5])
+                uint32_t id = shiftImmOps[in.below(FUZZ_COUNT(shiftImmOps))];
+                uint32_t rs1 = src();
+                int32_t imm = (int32_t)(in.below(32) | (id >> 10) << 5);
+                emit(encI(id, dest(true), rs1, imm), true);
+                break;
+            }
+            case 8: { // LUI/AUIPC
+                uint32_t id = in.below(2) ? LUI : AUIPC;
+                uint32_t imm = in.word();
+                emit(encU(id, dest(true), imm), true);
+                break;
+            }
+            case 9:
+            case 10: { // Load (from the data region)
+                uint32_t id = loadOps[in.below(FUZZ_COUNT(loadOps))];
+                int32_t off = loadStoreOff(id);
+                emit(encI(id, dest(true), FUZZ_DATA_REG, off), true);
+                break;
+            }
+            case 11: { // Store (to the data region)
+                uint32_t id = storeOps[in.below(FUZZ_COUNT(storeOps))];
+                uint32_t rs2 = src();
+                int32_t off = loadStoreOff(id);
+                emit(encS(id, FUZZ_DATA_REG, rs2, off), true);
+                break;
+            }
+            case 12:
+            case 13: { // Forward branch (13: on a just-loaded value)
+                uint32_t rs1 = ZERO;
+                if (kind == 13) {
+                    uint32_t load = loadOps[in.below(FUZZ_COUNT(loadOps))];
+                    int32_t off = loadStoreOff(load);
+                    rs1 = dest(true);
+                    emit(encI(load, rs1, FUZZ_DATA_REG, off), true);
+                } else {
+                    rs1 = src();
+                }
+                uint32_t id = branchOps[in.below(FUZZ_COUNT(branchOps))];
+                uint32_t rs2 = src();
+                int32_t off = forwardOff();
+                edges.push_back(code.size());
+                emit(encB(id, rs1, rs2, off), true);
+                break;
+            }
+            case 14: { // Forward JAL, or JALR (w/ an AUIPC'd base)
+                if (in.below(2)) {
+                    int32_t off = forwardOff();
+                    edges.push_back(code.size());
+                    emit(encJ(dest(true), off), true);
+                    break;
+                }
+                uint32_t base = dest(false);
+                emit(encU(AUIPC, base, 0), true);
+                int32_t off = forwardOff() + 4;
+                edges.push_back(code.size());
+                emit(encI(JALR, dest(true), base, off), false);
+                break;
+            }
+            case 15: { // Loop (closed by a later kind 15)
+                uint32_t count = 1 + in.below(FUZZ_MAX_LOOP_COUNT);
+                emit(encI(ADDI, FUZZ_LOOP_REG, ZERO, (int32_t)count), true);
+                loopStart = (int)code.size();
+                break;
+            }
+        }
+    }
+    if (loopStart >= 0) {
+        closeLoop();
+    }
+    // Pad so that all forward targets exist (and the last instructions have
+    // retired when the harness stops at the EBREAK)
+    for (int i = 0; i < FUZZ_TAIL_NOPS; ++i) {
+        emit(FUZZ_NOP, true);
+    }
+    emit(EBREAK, true);
+
+    // Move forward targets off of JALRs/loop branches (to the next instr)
+    for (size_t at : edges) {
+        uint32_t instr = code[at];
+        size_t base = (OPCODE(instr) == (JALR & 0x7f)) ? at - 1 : at;
+        int32_t off = (OPCODE(instr) == (JALR & 0x7f)) ? I_IMM(instr)
+                      : (OPCODE(instr) == JAL)         ? J_IMM(instr)
+                                                       : B_IMM(instr);
+        size_t target = base + off / 4;
+        while (noLand[target]) {
+            target++;
+        }
+        off = (int32_t)(target - base) * 4;
+        if (OPCODE(instr) == (JALR & 0x7f)) {
+            code[at] = (instr & 0x000fffff) | ((uint32_t)off & 0xfff) << 20;
+        } else if (OPCODE(instr) == JAL) {
+            code[at] = encJ(RD(instr), off);
+        } else {
+            code[at] = (instr & 0x01fff07f) | encB(0, 0, 0, off);
+        }
+    }
+    return prog;
+}
+
+std::vector<uint8_t> fuzzSeedInput(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> input(FUZZ_SEED_INPUT_LEN);
+    for (uint8_t &b : input) {
+        b = (uint8_t)rng();
+    }
+    return input;
+}
+
+std::string fuzzListing(const flintRVFuzzProgram &prog) {
+    std::string s;
+    for (size_t i = 0; i < prog.code.size(); ++i) {
+        appendf(s, "%8zx:   0x%08x   %s\n", i * 4, prog.code[i],
+                disassembleRv32i(prog.code[i]).c_str());
+    }
+    s += "Initial regfile:";
+    for (int i = 0; i < REGISTER_COUNT; ++i) {
+        appendf(s, "%s x%-2d 0x%08x", (i % 4 == 0) ? "\n" : "", i,
+                prog.regs[i]);
+    }
+    s += "\nInitial data:";
+    for (int i = 0; i < FUZZ_DATA_SIZE; ++i) {
+        if (i % 16 == 0) {
+            appendf(s, "\n [0x%x]", FUZZ_DATA_BASE + i);
+        }
+        appendf(s, " %02x", prog.data[i]);
+    }
+    s += "\n";
+    return s;
+}
+
+flintRVFuzzer::flintRVFuzzer() : m_dut(~(vluint64_t)0), m_created(false) {}
+
+bool flintRVFuzzer::run(const flintRVFuzzProgram &prog, std::string &report,
+                        bool cosim) {
+    report.clear();
+    std::vector<unsigned char> image(FUZZ_DATA_BASE + FUZZ_DATA_SIZE, 0);
+    std::memcpy(image.data(), prog.code.data(),
+                prog.code.size() * sizeof(uint32_t));
+    std::memcpy(&image[FUZZ_DATA_BASE], prog.data, FUZZ_DATA_SIZE);
+    if (!m_created) {
+        if (!m_dut.create() || !m_dut.createMemory(FUZZ_MEM_SIZE)) {
+            report = "Failed to create flintRV\n";
+            return false;
+        }
+        m_dut.m_cpu->i_ifValid = 1;
+        m_dut.m_cpu->i_memValid = 1;
+        m_created = true;
+    }
+
+    // RTL
+    if (!m_dut.reinit(image.data(), image.size())) {
+        report = "Failed to load the program\n";
+        return false;
+    }
+    for (int i = 1; i < REGISTER_COUNT; ++i) {
+        m_dut.writeRegfile(i, (int)prog.regs[i]);
+    }
+    m_dut.setCosim(cosim);
+    bool rtlOk = m_dut.run(FUZZ_MAX_CYCLES);
+    bool rtlDone = m_dut.end();
+
+    // Reference
+    std::vector<char> mem(FUZZ_MEM_SIZE, 0);
+    std::memcpy(mem.data(), image.data(), image.size());
+    bool refOk = m_ref.sync(mem.data(), mem.size(), prog.regs, 0) &&
+                 m_ref.fastForward(FUZZ_MAX_CYCLES);
+
+    if (!refOk || !m_ref.halted()) {
+        report = "Invalid program (rISA faulted or did not halt)\n";
+        return false;
+    }
+    if (!rtlOk) {
+        report = m_dut.cosimMismatch() ? "Co-simulation mismatch\n"
+                                       : "RTL fault\n";
+        return false;
+    }
+    if (!rtlDone) {
+        appendf(report, "RTL hang (no EBREAK after %d cycles)\n",
+                FUZZ_MAX_CYCLES);
+        return false;
+    }
+    for (int i = 1; i < REGISTER_COUNT; ++i) {
+        uint32_t rtl = (uint32_t)m_dut.readRegfile(i);
+        if (rtl != m_ref.regs()[i]) {
+            appendf(report, "x%d: RTL 0x%08x, ref 0x%08x\n", i, rtl,
+                    m_ref.regs()[i]);
+        }
+    }
+    for (size_t addr = 0; addr < FUZZ_MEM_SIZE; addr += 4) {
+        int rtl = 0;
+        uint32_t ref = ACCESS_MEM_W(m_ref.mem(), addr);
+        if (!m_dut.peekMem(addr, rtl) || (uint32_t)rtl != ref) {
+            appendf(report, "[0x%zx]: RTL 0x%08x, ref 0x%08x\n", addr,
+                    (uint32_t)rtl, ref);
+        }
+    }
+    return report.empty();
+}
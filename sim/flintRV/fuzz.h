@@ -0,0 +1,53 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cosim.h"
+#include "flintRV.h"
+
+// Fuzz program memory layout: code at 0x0, the data region loads/stores are
+// confined to (based at x31) after it
+#define FUZZ_MEM_SIZE 0x2000
+#define FUZZ_DATA_BASE 0x1000
+#define FUZZ_DATA_SIZE 64
+#define FUZZ_MAX_INSTRS 512
+#define FUZZ_SEED_INPUT_LEN 1024 // Input bytes generated per seed
+
+// Random (but terminating) RV32I program and its initial architectural state
+struct flintRVFuzzProgram {
+    std::vector<uint32_t> code; // Ends w/ NOP padding and an EBREAK
+    uint32_t regs[REGISTER_COUNT];
+    uint8_t data[FUZZ_DATA_SIZE];
+};
+
+// Generates a program from fuzzer input bytes (any input is valid). Streams
+// are biased towards back-to-back dependencies, loads feeding branches and
+// x0 writes. Branches/jumps only go forward, except bounded loops.
+flintRVFuzzProgram fuzzGenerate(const uint8_t *data, size_t len);
+// Input bytes of a seeded (i.e. non-coverage guided) fuzz run
+std::vector<uint8_t> fuzzSeedInput(uint64_t seed);
+// Disassembly listing and initial state of a program
+std::string fuzzListing(const flintRVFuzzProgram &prog);
+
+// Differential runner - runs a program on both the RTL and rISA, comparing
+// the final regfile and memory. Not thread safe (use one per thread).
+class flintRVFuzzer {
+  public:
+    flintRVFuzzer();
+    // False on a mismatch, hang or fault (described in report). With cosim,
+    // the RTL is also checked per retired instruction (printing the first
+    // diverging one).
+    bool run(const flintRVFuzzProgram &prog, std::string &report,
+             bool cosim = false);
+
+  private:
+    flintRV m_dut;
+    risaRef m_ref;
+    bool m_created;
+};
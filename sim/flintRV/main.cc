@@ -1,18 +1,101 @@
 // Copyright (c) 2022 - present, Austin Annestrand.
 // Licensed under the MIT License (see LICENSE file).
 
+#include <algorithm>
+#include <chrono>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
 #include "flintRV/flintRV.h"
+#include "flintRV/sampling.h"
 
 #include "common/utils.h"
 
 #include "miniargparse/miniargparse.h"
 
+#define DEFAULT_TRACE_WINDOW 1000   // Cycles dumped before/after a trigger
+#define DEFAULT_SAMPLE_WINDOW 10000 // Cycles measured per sample
+
 void printHelp(void) {
     printf("[Usage]: flintRV [OPTIONS] <program_binary>.hex\n\n"
            "OPTIONS:\n");
     miniargparsePrint();
 }
 
+// Creates the CPU, loads the program and inits the stack (or restores the
+// checkpoint, if given)
+bool initSim(flintRV &dut, int memSize, const char *programFile,
+             const char *traceFile, const char *checkpointFile) {
+    if (!dut.create(traceFile)) {
+        LOG_ERROR("Failed to create flintRV.");
+        return false;
+    }
+    if (!dut.createMemory(memSize, programFile)) {
+        LOG_ERROR("Failed to create memory.");
+        return false;
+    }
+    dut.m_cpu->i_ifValid = 1;  // Always valid since we assume combinatorial
+                               // read/write for test memory
+    dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
+                               // read/write for test memory
+    // Init stack and frame pointers
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+    if (checkpointFile != nullptr) {
+        if (!dut.restoreCheckpoint(checkpointFile)) {
+            return false;
+        }
+        LOG_INFO_PRINTF("Restored checkpoint at cycle %" PRIu64 ": %s",
+                        (uint64_t)dut.cycles(), checkpointFile);
+    }
+    return true;
+}
+
+// Runs for up to cycles (returns false on simulation errors)
+bool runSimFor(flintRV &dut, vluint64_t cycles) {
+    if (!dut.run(cycles)) {
+        if (!dut.cosimMismatch()) {
+            LOG_ERROR("Failed instruction fetch or load/store.");
+        }
+        return false;
+    }
+    return true;
+}
+
+// Runs until the simulation ends
+bool runSim(flintRV &dut) { return runSimFor(dut, ~(vluint64_t)0); }
+
+// Runs up to the given cycle and saves a checkpoint there (i.e. instead of
+// running until the simulation ends)
+bool checkpointSim(flintRV &dut, vluint64_t cycle, const char *file) {
+    if (cycle > dut.cycles() && !runSimFor(dut, cycle - dut.cycles())) {
+        return false;
+    }
+    if (dut.end()) {
+        LOG_ERROR("Simulation ended before the checkpoint cycle.");
+        return false;
+    }
+    if (!dut.saveCheckpoint(file)) {
+        return false;
+    }
+    LOG_INFO_PRINTF("Saved checkpoint at cycle %" PRIu64 ": %s",
+                    (uint64_t)dut.cycles(), file);
+    return true;
+}
+
+// Fast-forwards on rISA and only simulates the sample windows on the RTL
+bool sampleSim(flintRV &dut, const flintRVSampling &cfg) {
+    flintRVSampler sampler(cfg);
+    bool ok = sampler.run(dut);
+    printf("%s", LOG_LINE_BREAK);
+    sampler.print();
+    if (!ok && !dut.cosimMismatch()) {
+        LOG_ERROR("Sampled simulation failed.");
+    }
+    return ok;
+}
+
 int main(int argc, char *argv[]) {
     // Define opts
     MINIARGPARSE_OPT(
@@ -25,7 +108,50 @@ int main(int argc, char *argv[]) {
     MINIARGPARSE_OPT(simTime, "t", "timeout", 1,
                      "Simulation timeout value [DEFAULT=INT32_MAX].");
     MINIARGPARSE_OPT(simVcd, "V", "vcdDump", 1,
-                     "Filename for VCD dump [DEFAULT=Disabled].");
+                     "Filename for VCD/FST dump [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(traceStart, "", "traceStart", 1,
+                     "Cycle to start the VCD/FST dump at [DEFAULT=0].");
+    MINIARGPARSE_OPT(traceStop, "", "traceStop", 1,
+                     "Cycle to stop the VCD/FST dump at [DEFAULT=Never].");
+    MINIARGPARSE_OPT(
+        traceTrigger, "", "traceTriggerPc", 1,
+        "Only dump the cycles around the first fetch of this PC (hex) or "
+        "a simulation error/assertion - re-runs the program to dump them "
+        "[DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(traceWindow, "", "traceWindow", 1,
+                     "Cycles dumped before/after the trace trigger "
+                     "[DEFAULT=1000].");
+    MINIARGPARSE_OPT(cosim, "", "cosim", 0,
+                     "Check each retired instruction against the rISA "
+                     "reference model (stops at the first mismatch).");
+    MINIARGPARSE_OPT(fastForward, "", "fastForward", 1,
+                     "Run this many instructions on rISA, then hand off to "
+                     "the RTL for a sample window [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(fastForwardPc, "", "fastForwardPc", 1,
+                     "Run on rISA up to this PC (hex), then hand off to the "
+                     "RTL for a sample window [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(sampleWindow, "", "sampleWindow", 1,
+                     "Cycles measured per sample window [DEFAULT=10000].");
+    MINIARGPARSE_OPT(sampleWarmup, "", "sampleWarmup", 1,
+                     "Cycles run before measuring each sample window "
+                     "[DEFAULT=0].");
+    MINIARGPARSE_OPT(sampleInterval, "", "sampleInterval", 1,
+                     "Instructions between sample windows (fast-forwarded "
+                     "on rISA) [DEFAULT=0, i.e. one sample].");
+    MINIARGPARSE_OPT(perfJson, "", "perfJson", 1,
+                     "Write the performance counters/CPI breakdown to a JSON "
+                     "file [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(noPerf, "", "noPerf", 0,
+                     "Disable the performance counters (e.g. when measuring "
+                     "simulation speed).");
+    MINIARGPARSE_OPT(saveCkpt, "", "saveCheckpoint", 1,
+                     "Save a checkpoint at --checkpointCycle (instead of "
+                     "running to the end) [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(ckptCycle, "", "checkpointCycle", 1,
+                     "Cycle to save the checkpoint at [DEFAULT=0].");
+    MINIARGPARSE_OPT(restoreCkpt, "", "restoreCheckpoint", 1,
+                     "Restore a checkpoint (of the same program/build) and "
+                     "run from there [DEFAULT=Disabled].");
     MINIARGPARSE_OPT(version, "v", "version", 0, "Prints version and exits");
 
     // Parse the args
@@ -86,46 +212,130 @@ int main(int argc, char *argv[]) {
     LOG_INFO_PRINTF("Memory size set to: %f MB.",
                     (float)memSize / (float)(MB_MULTIPLIER));
 
+    vluint64_t traceStartVal =
+        traceStart.infoBits.used ? strtoull(traceStart.value, NULL, 0) : 0;
+    vluint64_t traceStopVal = traceStop.infoBits.used
+                                  ? strtoull(traceStop.value, NULL, 0)
+                                  : ~(vluint64_t)0;
+    vluint64_t traceWindowVal =
+        traceWindow.infoBits.used ? strtoull(traceWindow.value, NULL, 0) : 0;
+    if (traceWindowVal == 0) {
+        traceWindowVal = DEFAULT_TRACE_WINDOW;
+    }
+    vluint64_t ckptCycleVal =
+        ckptCycle.infoBits.used ? strtoull(ckptCycle.value, NULL, 0) : 0;
+    const char *restoreFile =
+        restoreCkpt.infoBits.used ? restoreCkpt.value : nullptr;
+    // Sampled simulation (the RTL only runs the sample windows)
+    bool sampled = fastForward.infoBits.used || fastForwardPc.infoBits.used;
+    flintRVSampling sampleCfg;
+    sampleCfg.fastForward =
+        fastForward.infoBits.used ? strtoull(fastForward.value, NULL, 0)
+                                  : (uint64_t)simTimeVal;
+    sampleCfg.fastForwardPc = fastForwardPc.infoBits.used
+                                  ? strtoul(fastForwardPc.value, NULL, 16)
+                                  : ~0u;
+    sampleCfg.interval = sampleInterval.infoBits.used
+                             ? strtoull(sampleInterval.value, NULL, 0)
+                             : 0;
+    sampleCfg.maxInstrs = simTimeVal;
+    sampleCfg.warmup = sampleWarmup.infoBits.used
+                           ? strtoull(sampleWarmup.value, NULL, 0)
+                           : 0;
+    sampleCfg.window = sampleWindow.infoBits.used
+                           ? strtoull(sampleWindow.value, NULL, 0)
+                           : DEFAULT_SAMPLE_WINDOW;
+    if (sampled && (saveCkpt.infoBits.used || restoreCkpt.infoBits.used ||
+                    traceTrigger.infoBits.used)) {
+        LOG_ERROR("Sampled simulation can't be combined with checkpoints or "
+                  "trace triggers.");
+        return 1;
+    }
+    // Triggered dumps are done by a second (deterministic) run
+    bool useTrigger = traceTrigger.infoBits.used && (simVcd.value != nullptr);
+    if (traceTrigger.infoBits.used && !useTrigger) {
+        LOG_WARNING("Trace trigger ignored, no dump file was given.");
+    }
+
     // Instantiate CPU
     flintRV dut = flintRV(simTimeVal, tracing.infoBits.used);
     LOG_INFO_PRINTF("Running simulator...");
     printf(OUTPUT_LINE);
-    if (!dut.create(new VflintRV(), simVcd.value)) {
-        LOG_ERROR("Failed to create flintRV.");
-        return 1;
+    if (useTrigger) {
+        dut.setTraceTrigger(strtoul(traceTrigger.value, NULL, 16));
+    } else {
+        dut.setTraceWindow(traceStartVal, traceStopVal);
     }
-    if (!dut.createMemory(memSize, programFile)) {
-        LOG_ERROR("Failed to create memory.");
+    if (!initSim(dut, memSize, programFile,
+                 useTrigger ? nullptr : simVcd.value, restoreFile)) {
         return 1;
     }
-    dut.m_cpu->i_ifValid = 1;  // Always valid since we assume combinatorial
-                               // read/write for test memory
-    dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
-                               // read/write for test memory
-    // Init stack and frame pointers
-    dut.writeRegfile(SP, memSize - 1);
-    dut.writeRegfile(FP, memSize - 1);
+    dut.setCosim(cosim.infoBits.used);
+    dut.setPerf(!noPerf.infoBits.used);
 
-    clock_t startTime = clock();
+    // Wall-clock (clock() would sum CPU time across model threads)
+    auto startTime = std::chrono::steady_clock::now();
 
     // Run
-    while (!dut.end()) {
-        if (!dut.instructionUpdate()) {
-            LOG_ERROR("Failed instruction fetch.");
+    bool simOk = true;
+    if (sampled) {
+        simOk = sampleSim(dut, sampleCfg);
+    } else {
+        simOk = saveCkpt.infoBits.used
+                    ? checkpointSim(dut, ckptCycleVal, saveCkpt.value)
+                    : runSim(dut);
+        printf("%s", LOG_LINE_BREAK);
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(endTime - startTime).count();
+    LOG_INFO_PRINTF("Simulation stopping, time elapsed: %f seconds.", elapsed);
+    LOG_INFO_PRINTF("Simulation speed: %.0f cycles/second.",
+                    (elapsed > 0.0) ? (double)dut.cycles() / elapsed : 0.0);
+    if (dut.perfEnabled()) {
+        LOG_INFO_PRINTF("Cycles: %" PRIu64 ", branches: %" PRIu64
+                        ", mispredicts: %" PRIu64 ".",
+                        (uint64_t)dut.cycles(), (uint64_t)dut.perf().branches,
+                        (uint64_t)dut.perf().mispredicts);
+    } else {
+        LOG_INFO_PRINTF("Cycles: %" PRIu64 ", no branch stats.",
+                        (uint64_t)dut.cycles());
+    }
+    dut.printPerf();
+    if (perfJson.infoBits.used && !dut.writePerfJson(perfJson.value)) {
+        simOk = false;
+    }
+
+    // Re-run up to the trigger w/ dumping enabled only around it
+    bool simError = !simOk || dut.gotFinish();
+    if (useTrigger && (dut.triggered() || simError)) {
+        vluint64_t trigger =
+            dut.triggered() ? dut.triggerCycle() : dut.cycles();
+        vluint64_t start =
+            (trigger > traceWindowVal) ? trigger - traceWindowVal : 0;
+        LOG_INFO_PRINTF("Trace trigger at cycle %" PRIu64
+                        ", dumping cycles [ %" PRIu64 " - %" PRIu64 " ]...",
+                        (uint64_t)trigger, (uint64_t)start,
+                        (uint64_t)(trigger + traceWindowVal));
+#if !FLINTRV_HAS_CONTEXT
+        Verilated::gotFinish(false); // Shared by all models
+#endif
+        flintRV replay(
+            std::min((vluint64_t)simTimeVal, trigger + traceWindowVal), false);
+        replay.setTraceWindow(start, trigger + traceWindowVal);
+        replay.setQuiet(true); // Program output was already printed
+        if (!initSim(replay, memSize, programFile, simVcd.value,
+                     restoreFile)) {
             return 1;
         }
-        if (!dut.loadStoreUpdate()) {
-            LOG_ERROR("Failed load/store fetch.");
-            return 1;
+        if (!runSim(replay) && simOk) {
+            LOG_ERROR("Trace replay failed (the first run did not).");
+            simOk = false;
         }
-        // Evaluate
-        dut.tick();
+        printf("%s", LOG_LINE_BREAK);
+    } else if (useTrigger) {
+        LOG_WARNING("Trace trigger never fired, nothing was dumped.");
     }
-    printf("%s", LOG_LINE_BREAK);
-
-    clock_t endTime = clock();
-    LOG_INFO_PRINTF("Simulation stopping, time elapsed: %f seconds.",
-                    ((double)(endTime - startTime)) / CLOCKS_PER_SEC);
 
-    return 0;
+    return simOk ? 0 : 1;
 }
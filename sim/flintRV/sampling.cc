@@ -0,0 +1,129 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "common/utils.h"
+#include "sampling.h"
+
+bool flintRVSampler::run(flintRV &dut) {
+    dut.setPerf(true); // Windows are measured w/ the cycle/retired counters
+    // Start from the harness' initial state (e.g. w/ the stack pointers set)
+    std::vector<char> image(dut.memSize());
+    for (size_t addr = 0; addr + sizeof(int) <= image.size();
+         addr += sizeof(int)) {
+        int val = 0;
+        if (!dut.peekMem(addr, val)) {
+            return false;
+        }
+        std::memcpy(&image[addr], &val, sizeof(val));
+    }
+    uint32_t regs[REGISTER_COUNT];
+    for (int i = 0; i < REGISTER_COUNT; ++i) {
+        regs[i] = dut.readRegfile(i);
+    }
+    if (!m_ref.sync(image.data(), image.size(), regs, dut.m_cpu->o_pcOut)) {
+        return false;
+    }
+    m_samples.clear();
+
+    uint64_t count = std::min(m_cfg.fastForward, m_cfg.maxInstrs);
+    if (!m_ref.fastForward(count, m_cfg.fastForwardPc)) {
+        return false;
+    }
+    if (m_cfg.fastForwardPc != ~0u && m_ref.pc() != m_cfg.fastForwardPc &&
+        !m_ref.halted()) {
+        LOG_WARNING_PRINTF("Fast-forward PC [ 0x%x ] was never reached.",
+                           m_cfg.fastForwardPc);
+        return true;
+    }
+    while (!m_ref.halted()) {
+        if (!sample(dut)) {
+            return false;
+        }
+        if (m_cfg.interval == 0) {
+            break;
+        }
+        if (m_ref.instret() >= m_cfg.maxInstrs) {
+            LOG_WARNING("Fast-forward timeout reached.");
+            break;
+        }
+        count = std::min(m_cfg.interval, m_cfg.maxInstrs - m_ref.instret());
+        if (!m_ref.fastForward(count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hands the rISA state off to the RTL model and measures one window
+bool flintRVSampler::sample(flintRV &dut) {
+    const char *mem = m_ref.mem();
+    for (size_t addr = 0; addr + sizeof(int) <= dut.memSize();
+         addr += sizeof(int)) {
+        int val = 0;
+        std::memcpy(&val, &mem[addr], sizeof(val));
+        if (!dut.pokeMem(addr, val)) {
+            return false;
+        }
+    }
+    for (int i = 1; i < REGISTER_COUNT; ++i) {
+        dut.writeRegfile(i, m_ref.regs()[i]);
+    }
+    dut.restartAt(m_ref.pc());
+
+    if (!dut.run(m_cfg.warmup)) {
+        return false;
+    }
+    flintRVPerf start = dut.perf();
+    if (!dut.run(m_cfg.window)) {
+        return false;
+    }
+    flintRVSample s;
+    s.instret = m_ref.instret();
+    s.pc = m_ref.pc();
+    s.cycles = dut.perf().cycles - start.cycles;
+    s.retired = dut.perf().retired - start.retired;
+    m_samples.push_back(s);
+    return true;
+}
+
+void flintRVSampler::print() const {
+    double sum = 0.0, sumSq = 0.0;
+    size_t n = 0;
+    printf("%-8s %16s %10s %14s %14s %8s\n", "sample", "instret", "pc",
+           "cycles", "retired", "CPI");
+    for (size_t i = 0; i < m_samples.size(); ++i) {
+        const flintRVSample &s = m_samples[i];
+        // Windows that started at the end of the program retire nothing
+        double cpi = (s.retired > 0) ? s.cycles / (double)s.retired : 0.0;
+        printf("%-8zu %16" PRIu64 " %10x %14" PRIu64 " %14" PRIu64 " %8.3f\n",
+               i, s.instret, s.pc, (uint64_t)s.cycles, (uint64_t)s.retired,
+               cpi);
+        if (s.retired > 0) {
+            sum += cpi;
+            sumSq += cpi * cpi;
+            n++;
+        }
+    }
+    if (n == 0) {
+        LOG_WARNING("No samples retired any instructions.");
+        return;
+    }
+    double mean = sum / n;
+    double var = (n > 1) ? std::max(0.0, (sumSq - n * mean * mean) / (n - 1))
+                         : 0.0;
+    double ci = 1.96 * std::sqrt(var / n);
+    LOG_INFO_PRINTF("Sampled CPI: %.3f +/- %.3f (95%% CI, %zu samples).",
+                    mean, ci, n);
+    LOG_INFO_PRINTF("Instructions: %" PRIu64 "%s, estimated cycles: %.0f.",
+                    m_ref.instret(),
+                    m_ref.halted() ? "" : " (program did not finish)",
+                    mean * m_ref.instret());
+}
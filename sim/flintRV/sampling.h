@@ -0,0 +1,48 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cosim.h"
+#include "flintRV.h"
+
+// Sampled simulation settings
+struct flintRVSampling {
+    uint64_t fastForward;   // Instructions run on rISA before the 1st sample
+    uint32_t fastForwardPc; // ...or stop before this PC first (~0u: disabled)
+    uint64_t interval;      // Instructions between samples (0: one sample)
+    uint64_t maxInstrs;     // Fast-forward limit (i.e. timeout)
+    vluint64_t warmup;      // RTL cycles run (not measured) before a window
+    vluint64_t window;      // RTL cycles measured per sample
+};
+
+// RTL measurement of one sample window
+struct flintRVSample {
+    uint64_t instret; // Instructions fast-forwarded before the hand-off
+    uint32_t pc;      // Hand-off PC
+    vluint64_t cycles;
+    vluint64_t retired;
+};
+
+// Fast-forwards a program on the rISA hart, handing its architectural state
+// (memory, regfile and PC) off to the RTL model for cycle-accurate windows
+class flintRVSampler {
+  public:
+    explicit flintRVSampler(const flintRVSampling &cfg) : m_cfg(cfg) {}
+    // Runs the program loaded into dut (i.e. starting from its memory,
+    // regfile and PC) until it ends - false on rISA/RTL errors
+    bool run(flintRV &dut);
+    // Prints each sample and the CPI estimate (mean w/ a 95% confidence
+    // interval, extrapolated to all of the fast-forwarded instructions)
+    void print() const;
+    const std::vector<flintRVSample> &samples() const { return m_samples; }
+
+  private:
+    bool sample(flintRV &dut);
+    flintRVSampling m_cfg;
+    risaRef m_ref;
+    std::vector<flintRVSample> m_samples;
+};
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "bbv.h"
+#include "common/utils.h"
+#include "types.h"
+
+struct BbvProfile {
+    FILE *file;
+    u32 interval;
+    u64 intervalCount;                // Instructions in the current interval
+    u32 blockStart;                   // PC of the current block's 1st instr
+    u32 blockLen;                     // Instructions in the current block
+    std::unordered_map<u32, u32> ids; // Block start PC -> ID (from 1)
+    std::vector<u64> counts;          // Instructions executed per block ID
+    std::vector<u32> touched;         // IDs executed in the current interval
+};
+
+bool bbvInit(rv32iHart *cpu, const char *file, u32 interval) {
+    FILE *f = fopen(file, "w");
+    if (f == NULL) {
+        LOG_ERROR_PRINTF("Could not open BBV file ( %s ).", file);
+        return false;
+    }
+    BbvProfile *bbv = new BbvProfile();
+    bbv->file = f;
+    bbv->interval = interval;
+    bbv->blockStart = cpu->pc;
+    cpu->bbv = bbv;
+    return true;
+}
+
+// Adds the current block to the interval (weighted by its instructions)
+static void bbvEndBlock(BbvProfile *bbv, u32 nextPc) {
+    if (bbv->blockLen > 0) {
+        auto it = bbv->ids.find(bbv->blockStart);
+        if (it == bbv->ids.end()) {
+            u32 id = (u32)bbv->ids.size() + 1;
+            it = bbv->ids.emplace(bbv->blockStart, id).first;
+            bbv->counts.push_back(0);
+        }
+        u64 &count = bbv->counts[it->second - 1];
+        if (count == 0) {
+            bbv->touched.push_back(it->second);
+        }
+        count += bbv->blockLen;
+    }
+    bbv->blockStart = nextPc;
+    bbv->blockLen = 0;
+}
+
+// Writes a "T:<id>:<count> :<id>:<count> ..." line for the interval
+static void bbvEndInterval(BbvProfile *bbv) {
+    if (bbv->touched.empty()) {
+        return;
+    }
+    std::sort(bbv->touched.begin(), bbv->touched.end());
+    fprintf(bbv->file, "T");
+    for (u32 id : bbv->touched) {
+        fprintf(bbv->file, ":%u:%" PRIu64 " ", id, bbv->counts[id - 1]);
+        bbv->counts[id - 1] = 0;
+    }
+    fprintf(bbv->file, "\n");
+    bbv->touched.clear();
+    bbv->intervalCount = 0;
+}
+
+void bbvUpdate(rv32iHart *cpu) {
+    BbvProfile *bbv = cpu->bbv;
+    bbv->blockLen++;
+    bbv->intervalCount++;
+    // Blocks end at control transfers (taken or not) and environment calls
+    switch (cpu->instFields.opcode) {
+        case B:
+        case J:
+        case I_JUMP:
+        case I_SYS: {
+            bbvEndBlock(bbv, cpu->pc + cpu->instrLen);
+            // Intervals end on block boundaries (i.e. hold >= N instructions)
+            if (bbv->intervalCount >= bbv->interval) {
+                bbvEndInterval(bbv);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void bbvFinish(rv32iHart *cpu) {
+    BbvProfile *bbv = cpu->bbv;
+    if (bbv == NULL) {
+        return;
+    }
+    bbvEndBlock(bbv, cpu->pc);
+    bbvEndInterval(bbv);
+    fclose(bbv->file);
+    LOG_INFO_PRINTF("BBV profile written: %zu basic blocks.", bbv->ids.size());
+    delete bbv;
+    cpu->bbv = NULL;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "risa.h"
+
+// Basic-block vector (BBV) profiling - writes the execution counts of each
+// basic block per interval of instructions in the SimPoint ".bb" format
+struct BbvProfile;
+
+bool bbvInit(rv32iHart *cpu, const char *file, u32 interval);
+// Counts the instruction just executed (call before advancing the PC)
+void bbvUpdate(rv32iHart *cpu);
+// Flushes the last (partial) interval and closes the file
+void bbvFinish(rv32iHart *cpu);
@@ -6,7 +6,8 @@
 
 #include "minigdbstub/minigdbstub.h"
 
-void gdbserverInit(rv32iHart *cpu) {
+// False if the server could not be set up (the caller cleans up)
+bool gdbserverInit(rv32iHart *cpu) {
     cpu->gdbFields.serverPort = 3333;
 
     if ((cpu->gdbFields.socketFd > 0) || (cpu->gdbFields.connectFd > 0)) {
@@ -14,9 +15,7 @@ void gdbserverInit(rv32iHart *cpu) {
     }
 
     if (startServer(cpu) < 0) {
-        printf(LOG_LINE_BREAK);
-        cleanupSimulator(cpu);
-        exit(-1);
+        return false;
     }
 
     if (cpu->gdbFields.socketFd > 0) {
@@ -27,7 +26,7 @@ void gdbserverInit(rv32iHart *cpu) {
             "execution.");
         cpu->opts.o_gdbEnabled = 0;
     }
-    return;
+    return true;
 }
 
 void gdbserverCall(rv32iHart *cpu) {
@@ -118,8 +117,5 @@ static void minigdbstubUsrProcessBreakpoint(int type, size_t addr,
 
 static void minigdbstubUsrKillSession(void *usrData) {
     rv32iHart *cpuHandle = (rv32iHart *)usrData;
-    cpuHandle->endTime = clock();
-    printf(LOG_LINE_BREAK);
-    cleanupSimulator(cpuHandle);
-    exit(0);
+    requestStop(cpuHandle, RISA_STOP_KILLED);
 }
@@ -13,6 +13,6 @@
 #endif
 
 void gdbserverCall(rv32iHart *cpu);
-void gdbserverInit(rv32iHart *cpu);
+bool gdbserverInit(rv32iHart *cpu);
 
 #endif // GDBSTUB_H
@@ -9,40 +9,96 @@
 #define SYS_exit 93
 #define SYS_write 64
 
+risa_handler g_defaultHandlerTable[RISA_HANDLER_PROC_COUNT] = {
+    defaultMmioHandler, defaultIntHandler, defaultEnvHandler,
+    defaultInitHandler, defaultExitHandler};
+const char *g_handlerProcNames[RISA_HANDLER_PROC_COUNT] = {
+    "risaMmioHandler", "risaIntHandler",  "risaEnvHandler",
+    "risaInitHandler", "risaExitHandler",
+};
+
 void defaultMmioHandler(rv32iHart *cpu) { return; }
 void defaultIntHandler(rv32iHart *cpu) { return; }
 void defaultExitHandler(rv32iHart *cpu) { return; }
 void defaultInitHandler(rv32iHart *cpu) { return; }
 
+// Loads the handler library procs (defaults for the missing ones) and
+// allocates the hart's memory (0 memSize/intPeriod: defaults)
+bool setupHart(rv32iHart *cpu, u32 memSize, u32 intPeriod,
+               const char *handlerLib, bool warnMissing) {
+    // Load handler lib and syms (if given)
+    cpu->handlerLib = LOAD_LIB(handlerLib);
+    if (warnMissing && cpu->handlerLib == NULL) {
+        LOG_WARNING_PRINTF("Could not load dynamic library ( %s ).",
+                           handlerLib);
+    }
+    for (int i = 0; i < RISA_HANDLER_PROC_COUNT; ++i) {
+        cpu->handlerProcs[i] =
+            (risa_handler)LOAD_SYM(cpu->handlerLib, g_handlerProcNames[i]);
+        if (cpu->handlerProcs[i] == NULL) {
+            cpu->handlerProcs[i] = g_defaultHandlerTable[i];
+            if (warnMissing) {
+                LOG_WARNING_PRINTF(
+                    "Could not load %s - using default stub instead.",
+                    g_handlerProcNames[i]);
+            }
+        }
+    }
+
+    // Interrupt period and virtual memory config
+    cpu->intPeriodVal = (intPeriod != 0) ? intPeriod : DEFAULT_INT_PERIOD;
+    cpu->virtMemSize = (memSize != 0) ? memSize : DEFAULT_VIRT_MEM_SIZE;
+    cpu->virtMem = (u32 *)malloc(cpu->virtMemSize);
+    if (cpu->virtMem == NULL) {
+        LOG_ERROR("Could not allocate virtual memory.");
+        return false;
+    }
+    return true;
+}
+
+// Runs the exit handler and frees what setupHart()/the handlers allocated
+void cleanupHart(rv32iHart *cpu) {
+    if (cpu->handlerProcs[RISA_EXIT_HANDLER_PROC] != NULL) {
+        cpu->handlerProcs[RISA_EXIT_HANDLER_PROC](cpu);
+    }
+    if (cpu->virtMem != NULL) {
+        free(cpu->virtMem);
+        cpu->virtMem = NULL;
+    }
+    if (cpu->handlerData != NULL) {
+        free(cpu->handlerData);
+        cpu->handlerData = NULL;
+    }
+    if (cpu->handlerLib != NULL) {
+        CLOSE_LIB(cpu->handlerLib);
+        cpu->handlerLib = NULL;
+    }
+}
+
 // Provide a default simple/basic syscall handler
 void defaultEnvHandler(rv32iHart *cpu) {
+    if (cpu->ID == FENCE) {
+        return;
+    }
     if (cpu->ID == EBREAK) {
         // Default handler will just end simulation on EBREAK
-        cpu->endTime = clock();
-        printf(LOG_LINE_BREAK);
-        cpu->cleanupSimulator(cpu);
-        exit(0);
+        requestStop(cpu, RISA_STOP_EBREAK);
+        return;
     }
 
     // Otherwise we are processing an ECALL
     switch (cpu->regFile[A7]) {
         case SYS_exit: {
-            cpu->endTime = clock();
-            // Print out return error code (if there is an error)
-            printf(LOG_LINE_BREAK);
-            int err = (int)cpu->regFile[A0];
-            if (err) {
-                LOG_INFO_PRINTF(
-                    "Program code on simulator has returned error code: [ %d ]",
-                    err);
-            }
-            cpu->cleanupSimulator(cpu);
-            exit(0);
+            requestStop(cpu, RISA_STOP_EXIT, (int)cpu->regFile[A0]);
+            break;
         }
         case SYS_write: {
-            int base = cpu->regFile[A1];
+            u32 base = cpu->regFile[A1];
             u32 len = cpu->regFile[A2];
-            for (u32 i = 0; i < len; ++i) {
+            for (u32 i = 0; !cpu->opts.o_quiet && i < len; ++i) {
+                if (base + i >= cpu->virtMemSize) {
+                    break;
+                }
                 printf("%c", ACCESS_MEM_B(cpu->virtMem, base + i));
                 fflush(stdout);
             }
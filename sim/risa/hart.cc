@@ -0,0 +1,423 @@
+#include <cerrno>
+#include <cstdio>
+
+#include "common/utils.h"
+#include "risa.h"
+#include "types.h"
+
+// Fetches, decodes and executes the instruction at cpu->pc (the PC is not
+// advanced, control transfers leave it at target - instrLen). Returns 0, or
+// EILSEQ on an invalid instruction.
+int executeInstruction(rv32iHart *cpu) {
+    // Fetch (the 2nd halfword only for 32b instructions)
+    cpu->IF = ACCESS_MEM_H(cpu->virtMem, cpu->pc);
+    cpu->instrLen = 2;
+    if (!IS_COMPRESSED(cpu->IF)) {
+        cpu->IF = ACCESS_MEM_W(cpu->virtMem, cpu->pc);
+        cpu->instrLen = 4;
+    }
+    if (cpu->opts.o_tracePrintEnable) {
+        printf("%8x:   0x%08x   %-30s\n", cpu->pc, cpu->IF,
+               disassembleRv32i(cpu->IF).c_str());
+    }
+    // RV32C - execute as the equivalent 32b instruction (illegal encodings
+    // are left as-is and fall through to the invalid instruction path)
+    if (cpu->instrLen == 2 &&
+        expandCompressed((u16)cpu->IF) != COMPRESSED_ILLEGAL) {
+        cpu->IF = expandCompressed((u16)cpu->IF);
+    }
+    cpu->instFields.opcode = OPCODE(cpu->IF);
+    switch (cpu->instFields.opcode) {
+        case R: {
+            // Decode
+            cpu->instFields.rd = RD(cpu->IF);
+            cpu->instFields.rs1 = RS1(cpu->IF);
+            cpu->instFields.rs2 = RS2(cpu->IF);
+            cpu->instFields.funct3 = FUNCT3(cpu->IF);
+            cpu->instFields.funct7 = FUNCT7(cpu->IF);
+            cpu->ID = (cpu->instFields.funct7 << 10) |
+                      (cpu->instFields.funct3 << 7) |
+                      cpu->instFields.opcode;
+            // Execute
+            switch (cpu->ID) {
+                case ADD: { // Addition
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] +
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SUB: { // Subtraction
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] -
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SLL: { // Shift left logical
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1]
+                        << cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SLT: { // Set if less than (signed)
+                    cpu->regFile[cpu->instFields.rd] =
+                        ((s32)cpu->regFile[cpu->instFields.rs1] <
+                         (s32)cpu->regFile[cpu->instFields.rs2])
+                            ? 1
+                            : 0;
+                    break;
+                }
+                case SLTU: { // Set if less than (unsigned)
+                    cpu->regFile[cpu->instFields.rd] =
+                        (cpu->regFile[cpu->instFields.rs1] <
+                         cpu->regFile[cpu->instFields.rs2])
+                            ? 1
+                            : 0;
+                    break;
+                }
+                case XOR: { // Bitwise xor
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] ^
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SRL: { // Shift right logical
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] >>
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SRA: { // Shift right arithmetic
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)((s32)cpu->regFile[cpu->instFields.rs1] >>
+                              cpu->regFile[cpu->instFields.rs2]);
+                    break;
+                }
+                case OR: { // Bitwise or
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] |
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case AND: { // Bitwise and
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] &
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case ANDN:
+                case ORN:
+                case XNOR:
+                case MIN:
+                case MINU:
+                case MAX:
+                case MAXU:
+                case ROL:
+                case ROR:
+                case ZEXT_H:
+                case SH1ADD:
+                case SH2ADD:
+                case SH3ADD: { // Zba/Zbb
+                    cpu->regFile[cpu->instFields.rd] = executeZb(
+                        cpu->ID, cpu->regFile[cpu->instFields.rs1],
+                        cpu->regFile[cpu->instFields.rs2]);
+                    break;
+                }
+            }
+            break;
+        }
+        case I_ARITH:
+        case I_FENCE:
+        case I_JUMP:
+        case I_LOAD:
+        case I_SYS: {
+            // Decode
+            cpu->instFields.rd = RD(cpu->IF);
+            cpu->instFields.rs1 = RS1(cpu->IF);
+            cpu->instFields.funct3 = FUNCT3(cpu->IF);
+            cpu->immFields.imm11_0 = IMM_11_0(cpu->IF);
+            cpu->immFields.succ = SUCC(cpu->IF);
+            cpu->immFields.pred = PRED(cpu->IF);
+            cpu->immFields.fm = FM(cpu->IF);
+            cpu->immFinal = (((s32)cpu->immFields.imm11_0 << 20) >> 20);
+            cpu->ID = (cpu->instFields.opcode == I_ARITH)
+                          ? I_ARITH_ID(cpu->IF)
+                          : (cpu->instFields.funct3 << 7) |
+                                cpu->instFields.opcode;
+            cpu->targetAddress =
+                cpu->regFile[cpu->instFields.rs1] + cpu->immFinal;
+            // Execute
+            switch (cpu->ID) {
+                case SLLI: { // Shift left logical by immediate (i.e. rs2 is
+                             // shamt)
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1]
+                        << (cpu->immFinal & 0x1f);
+                    break;
+                }
+                case SRLI: { // Shift right logical by immediate (i.e. rs2
+                             // is shamt)
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] >>
+                        (cpu->immFinal & 0x1f);
+                    break;
+                }
+                case SRAI: { // Shift right arithmetic by immediate (i.e.
+                             // rs2 is shamt)
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)((s32)cpu->regFile[cpu->instFields.rs1] >>
+                              (cpu->immFinal & 0x1f));
+                    break;
+                }
+                case RORI:
+                case CLZ:
+                case CTZ:
+                case CPOP:
+                case SEXT_B:
+                case SEXT_H:
+                case ORC_B:
+                case REV8: { // Zbb (rs2 field is the shamt or op select)
+                    cpu->regFile[cpu->instFields.rd] = executeZb(
+                        cpu->ID, cpu->regFile[cpu->instFields.rs1],
+                        cpu->immFinal & 0x1f);
+                    break;
+                }
+                case JALR: { // Jump and link register
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->pc + cpu->instrLen;
+                    cpu->pc = ((cpu->targetAddress) & 0xfffffffe) -
+                              cpu->instrLen;
+                    break;
+                }
+                case LB: { // Load byte (signed)
+                    u32 loadByte =
+                        (u32)ACCESS_MEM_B(cpu->virtMem, cpu->targetAddress);
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)((s32)(loadByte << 24) >> 24);
+                    break;
+                }
+                case LH: { // Load halfword (signed)
+                    u32 loadHalfword =
+                        (u32)ACCESS_MEM_H(cpu->virtMem, cpu->targetAddress);
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)((s32)(loadHalfword << 16) >> 16);
+                    break;
+                }
+                case LW: { // Load word
+                    cpu->regFile[cpu->instFields.rd] =
+                        ACCESS_MEM_W(cpu->virtMem, cpu->targetAddress);
+                    break;
+                }
+                case LBU: { // Load byte (unsigned)
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)ACCESS_MEM_B(cpu->virtMem, cpu->targetAddress);
+                    break;
+                }
+                case LHU: { // Load halfword (unsigned)
+                    cpu->regFile[cpu->instFields.rd] =
+                        (u32)ACCESS_MEM_H(cpu->virtMem, cpu->targetAddress);
+                    break;
+                }
+                case ADDI: { // Add immediate
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] + cpu->immFinal;
+                    break;
+                }
+                case SLTI: { // Set if less than immediate (signed)
+                    cpu->regFile[cpu->instFields.rd] =
+                        ((s32)cpu->regFile[cpu->instFields.rs1] <
+                         cpu->immFinal)
+                            ? 1
+                            : 0;
+                    break;
+                }
+                case SLTIU: { // Set if less than immediate (unsigned)
+                    cpu->regFile[cpu->instFields.rd] =
+                        (cpu->regFile[cpu->instFields.rs1] <
+                         (u32)cpu->immFinal)
+                            ? 1
+                            : 0;
+                    break;
+                }
+                case XORI: { // Bitwise exclusive or immediate
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] ^ cpu->immFinal;
+                    break;
+                }
+                case ORI: { // Bitwise or immediate
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] | cpu->immFinal;
+                    break;
+                }
+                case ANDI: { // Bitwise and immediate
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->regFile[cpu->instFields.rs1] & cpu->immFinal;
+                    break;
+                }
+                case FENCE: { // FENCE - order device I/O and memory
+                              // accesses
+                    cpu->handlerProcs[RISA_ENV_HANDLER_PROC](cpu);
+                    break;
+                }
+                // Catch environment-type instructions
+                default: {
+                    cpu->ID = (cpu->immFields.imm11_0 << 20) |
+                              (cpu->instFields.funct3 << 7) |
+                              cpu->instFields.opcode;
+                    switch (cpu->ID) {
+                        case ECALL: { // ECALL - request a syscall
+                            cpu->handlerProcs[RISA_ENV_HANDLER_PROC](cpu);
+                            break;
+                        }
+                        case EBREAK: { // EBREAK - halt processor execution,
+                                       // transfer control to debugger
+                            cpu->handlerProcs[RISA_ENV_HANDLER_PROC](cpu);
+                            break;
+                        }
+                        default: { // Invalid instruction
+                            return EILSEQ;
+                        }
+                    }
+                }
+            }
+            break;
+        }
+        case S: {
+            // Decode
+            cpu->instFields.funct3 = FUNCT3(cpu->IF);
+            cpu->immFields.imm4_0 = IMM_4_0(cpu->IF);
+            cpu->instFields.rs1 = RS1(cpu->IF);
+            cpu->instFields.rs2 = RS2(cpu->IF);
+            cpu->immFields.imm11_5 = IMM_11_5(cpu->IF);
+            cpu->immPartial =
+                cpu->immFields.imm4_0 | (cpu->immFields.imm11_5 << 5);
+            cpu->immFinal = (((s32)cpu->immPartial << 20) >> 20);
+            cpu->ID =
+                (cpu->instFields.funct3 << 7) | cpu->instFields.opcode;
+            cpu->targetAddress =
+                cpu->regFile[cpu->instFields.rs1] + cpu->immFinal;
+            // Execute
+            switch (cpu->ID) {
+                case SB: { // Store byte
+                    ACCESS_MEM_B(cpu->virtMem, cpu->targetAddress) =
+                        (u8)cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SH: { // Store halfword
+                    ACCESS_MEM_H(cpu->virtMem, cpu->targetAddress) =
+                        (u16)cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+                case SW: { // Store word
+                    ACCESS_MEM_W(cpu->virtMem, cpu->targetAddress) =
+                        cpu->regFile[cpu->instFields.rs2];
+                    break;
+                }
+            }
+            cpu->handlerProcs[RISA_MMIO_HANDLER_PROC](cpu);
+            break;
+        }
+        case B: {
+            // Decode
+            cpu->instFields.rs1 = RS1(cpu->IF);
+            cpu->instFields.rs2 = RS2(cpu->IF);
+            cpu->instFields.funct3 = FUNCT3(cpu->IF);
+            cpu->immFields.imm11 = IMM_11_B(cpu->IF);
+            cpu->immFields.imm4_1 = IMM_4_1(cpu->IF);
+            cpu->immFields.imm10_5 = IMM_10_5(cpu->IF);
+            cpu->immFields.imm12 = IMM_12(cpu->IF);
+            cpu->immPartial =
+                cpu->immFields.imm4_1 | (cpu->immFields.imm10_5 << 4) |
+                (cpu->immFields.imm11 << 10) | (cpu->immFields.imm12 << 11);
+            cpu->targetAddress = (s32)(cpu->immPartial << 20) >> 19;
+            cpu->ID =
+                (cpu->instFields.funct3 << 7) | cpu->instFields.opcode;
+            // Execute
+            switch (cpu->ID) {
+                case BEQ: { // Branch if Equal
+                    if ((s32)cpu->regFile[cpu->instFields.rs1] ==
+                        (s32)cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+                case BNE: { // Branch if Not Equal
+                    if ((s32)cpu->regFile[cpu->instFields.rs1] !=
+                        (s32)cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+                case BLT: { // Branch if Less Than
+                    if ((s32)cpu->regFile[cpu->instFields.rs1] <
+                        (s32)cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+                case BGE: { // Branch if Greater Than or Equal
+                    if ((s32)cpu->regFile[cpu->instFields.rs1] >=
+                        (s32)cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+                case BLTU: { // Branch if Less Than (unsigned)
+                    if (cpu->regFile[cpu->instFields.rs1] <
+                        cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+                case BGEU: { // Branch if Greater Than or Equal (unsigned)
+                    if (cpu->regFile[cpu->instFields.rs1] >=
+                        cpu->regFile[cpu->instFields.rs2]) {
+                        cpu->pc += cpu->targetAddress - cpu->instrLen;
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        case U_AUIPC:
+        case U_LUI: {
+            // Decode
+            cpu->instFields.rd = RD(cpu->IF);
+            cpu->immFields.imm31_12 = IMM_31_12(cpu->IF);
+            cpu->immFinal = cpu->immFields.imm31_12 << 12;
+            // Execute
+            switch (cpu->instFields.opcode) {
+                case LUI: { // Load Upper Immediate
+                    cpu->regFile[cpu->instFields.rd] = cpu->immFinal;
+                    break;
+                }
+                case AUIPC: { // Add Upper Immediate to cpu->pc
+                    cpu->regFile[cpu->instFields.rd] =
+                        cpu->pc + cpu->immFinal;
+                    break;
+                }
+            }
+            break;
+        }
+        case J: {
+            // Decode
+            cpu->instFields.rd = RD(cpu->IF);
+            cpu->immFields.imm19_12 = IMM_19_12(cpu->IF);
+            cpu->immFields.imm11 = IMM_11_J(cpu->IF);
+            cpu->immFields.imm10_1 = IMM_10_1(cpu->IF);
+            cpu->immFields.imm20 = IMM_20(cpu->IF);
+            cpu->immPartial = cpu->immFields.imm10_1 |
+                              (cpu->immFields.imm11 << 10) |
+                              (cpu->immFields.imm19_12 << 11) |
+                              (cpu->immFields.imm20 << 19);
+            cpu->targetAddress = (s32)(cpu->immPartial << 12) >> 11;
+            // Execute
+            cpu->regFile[cpu->instFields.rd] = cpu->pc + cpu->instrLen;
+            cpu->pc += cpu->targetAddress - cpu->instrLen;
+            break;
+        }
+        default: { // Invalid instruction
+            return EILSEQ;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "bbv.h"
+#include "common/utils.h"
+#include "librisa.h"
+#include "risa.h"
+#include "types.h"
+
+struct risaHart {
+    rv32iHart cpu;
+    uint64_t instret;
+};
+
+// True if the instruction at the PC would fetch, load or store outside of
+// memory (executeInstruction() does not bounds check)
+static bool accessFault(const rv32iHart *cpu) {
+    if (!fetchInBounds(cpu)) {
+        return true;
+    }
+    u32 instr = ACCESS_MEM_H(cpu->virtMem, cpu->pc);
+    if (IS_COMPRESSED(instr)) {
+        instr = expandCompressed((u16)instr);
+    } else {
+        instr = ACCESS_MEM_W(cpu->virtMem, cpu->pc);
+    }
+    u32 addr = 0;
+    switch (OPCODE(instr)) {
+        case I_LOAD:
+            addr = cpu->regFile[RS1(instr)] + (I_IMM(instr));
+            break;
+        case S:
+            addr = cpu->regFile[RS1(instr)] + (S_IMM(instr));
+            break;
+        default:
+            return false;
+    }
+    u32 size = 1u << (FUNCT3(instr) & 0x3);
+    return (size_t)addr + size > cpu->virtMemSize;
+}
+
+risaHart *risaCreate(const risaConfig *cfg) {
+    const risaConfig defaults = {};
+    if (cfg == NULL) {
+        cfg = &defaults;
+    }
+    risaHart *hart = new (std::nothrow) risaHart();
+    if (hart == NULL) {
+        return NULL;
+    }
+    rv32iHart *cpu = &hart->cpu;
+    if (!setupHart(cpu, cfg->memSize, cfg->intPeriod, cfg->handlerLib,
+                   cfg->handlerLib != NULL)) {
+        cleanupHart(cpu);
+        delete hart;
+        return NULL;
+    }
+    cpu->opts.o_tracePrintEnable = cfg->tracing;
+    cpu->opts.o_quiet = cfg->quiet;
+    cpu->handlerProcs[RISA_INIT_HANDLER_PROC](cpu);
+    risaLoad(hart, NULL, 0);
+    // Profiles everything executed until risaDestroy()
+    if (cfg->bbvFile != NULL) {
+        if (cfg->bbvInterval == 0) {
+            LOG_ERROR("BBV interval must be non-zero.");
+            risaDestroy(hart);
+            return NULL;
+        }
+        if (!bbvInit(cpu, cfg->bbvFile, cfg->bbvInterval)) {
+            risaDestroy(hart);
+            return NULL;
+        }
+    }
+    return hart;
+}
+
+void risaDestroy(risaHart *hart) {
+    if (hart == NULL) {
+        return;
+    }
+    bbvFinish(&hart->cpu);
+    cleanupHart(&hart->cpu);
+    delete hart;
+}
+
+bool risaLoad(risaHart *hart, const void *image, size_t len) {
+    rv32iHart *cpu = &hart->cpu;
+    if (len > cpu->virtMemSize) {
+        LOG_ERROR("Cannot fit the program image into memory!");
+        return false;
+    }
+    std::memset(cpu->virtMem, 0, cpu->virtMemSize);
+    if (len > 0) {
+        std::memcpy(cpu->virtMem, image, len);
+    }
+    std::memset(cpu->regFile, 0, sizeof(cpu->regFile));
+    cpu->regFile[SP] = cpu->regFile[FP] = STACK_TOP(cpu->virtMemSize);
+    cpu->pc = 0;
+    cpu->cycleCounter = 0;
+    requestStop(cpu, RISA_STOP_NONE);
+    hart->instret = 0;
+    return true;
+}
+
+risaStopReason risaStep(risaHart *hart) {
+    rv32iHart *cpu = &hart->cpu;
+    if (cpu->stopReason != RISA_STOP_NONE) {
+        return cpu->stopReason;
+    }
+    if (accessFault(cpu) || executeInstruction(cpu) != 0) {
+        requestStop(cpu, RISA_STOP_FAULT);
+        return cpu->stopReason;
+    }
+    cpu->regFile[ZERO] = 0;
+    hart->instret++;
+    if (cpu->bbv != NULL) {
+        bbvUpdate(cpu);
+    }
+    if (cpu->stopReason != RISA_STOP_NONE) {
+        return cpu->stopReason; // PC is left at the EBREAK/ECALL
+    }
+    if ((++cpu->cycleCounter % cpu->intPeriodVal) == 0) {
+        cpu->handlerProcs[RISA_INT_HANDLER_PROC](cpu);
+    }
+    cpu->pc += cpu->instrLen;
+    return RISA_STOP_NONE;
+}
+
+risaStopReason risaRun(risaHart *hart, uint64_t maxInstrs) {
+    for (uint64_t i = 0; i < maxInstrs; ++i) {
+        risaStopReason stop = risaStep(hart);
+        if (stop != RISA_STOP_NONE) {
+            return stop;
+        }
+    }
+    return RISA_STOP_BUDGET;
+}
+
+risaStopReason risaStopped(const risaHart *hart) {
+    return hart->cpu.stopReason;
+}
+
+int32_t risaExitCode(const risaHart *hart) { return hart->cpu.exitCode; }
+
+uint64_t risaInstret(const risaHart *hart) { return hart->instret; }
+
+uint32_t risaGetPc(const risaHart *hart) { return hart->cpu.pc; }
+
+void risaSetPc(risaHart *hart, uint32_t pc) {
+    hart->cpu.pc = pc;
+    requestStop(&hart->cpu, RISA_STOP_NONE);
+}
+
+uint32_t risaGetReg(const risaHart *hart, unsigned int index) {
+    return (index < REGISTER_COUNT) ? hart->cpu.regFile[index] : 0;
+}
+
+void risaSetReg(risaHart *hart, unsigned int index, uint32_t val) {
+    if (index != ZERO && index < REGISTER_COUNT) {
+        hart->cpu.regFile[index] = val;
+    }
+}
+
+uint8_t *risaMem(risaHart *hart) { return (uint8_t *)hart->cpu.virtMem; }
+
+uint32_t risaMemSize(const risaHart *hart) { return hart->cpu.virtMemSize; }
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Embeddable rISA (C API) - each risaHart owns its memory/handlers, so many
+// can be created and run in-process (one thread per hart at a time)
+
+#if defined(_WIN32) && defined(LIBRISA_SHARED)
+#ifdef LIBRISA_BUILD
+#define RISA_API __declspec(dllexport)
+#else
+#define RISA_API __declspec(dllimport)
+#endif
+#else
+#define RISA_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Why a hart stopped
+typedef enum {
+    RISA_STOP_NONE = 0, // Not stopped (e.g. risaStep() executed one instr)
+    RISA_STOP_EXIT,     // SYS_exit ECALL (see risaExitCode())
+    RISA_STOP_EBREAK,   // EBREAK
+    RISA_STOP_FAULT,    // Invalid instruction or out-of-bounds access
+    RISA_STOP_BUDGET,   // risaRun() executed maxInstrs
+    RISA_STOP_KILLED    // GDB killed the session (risa CLI only)
+} risaStopReason;
+
+typedef struct {
+    uint32_t memSize;       // Bytes (0: 32KB)
+    uint32_t intPeriod;     // Instrs between interrupt handler calls (0: 500)
+    const char *handlerLib; // User handler library (NULL: default handlers)
+    bool tracing;           // Print each executed instruction
+    bool quiet;             // Drop program output (SYS_write)
+    const char *bbvFile;    // BBV profile output (NULL: disabled)
+    uint32_t bbvInterval;   // Instrs per BBV interval (needs a bbvFile)
+} risaConfig;
+
+typedef struct risaHart risaHart;
+
+// NULL on errors (e.g. memory allocation) - a NULL cfg uses the defaults
+RISA_API risaHart *risaCreate(const risaConfig *cfg);
+RISA_API void risaDestroy(risaHart *hart);
+// Clears the memory/regfile, copies the program image to address 0 and
+// resets the hart to run it (PC 0, SP/FP at the stack top)
+RISA_API bool risaLoad(risaHart *hart, const void *image, size_t len);
+// Executes one instruction - RISA_STOP_NONE if the hart can keep going.
+// EXIT/EBREAK/FAULT stops stick (the PC is left at the stopping
+// instruction) until the next risaLoad()/risaSetPc().
+RISA_API risaStopReason risaStep(risaHart *hart);
+// Executes up to maxInstrs instructions (never RISA_STOP_NONE)
+RISA_API risaStopReason risaRun(risaHart *hart, uint64_t maxInstrs);
+RISA_API risaStopReason risaStopped(const risaHart *hart);
+RISA_API int32_t risaExitCode(const risaHart *hart); // SYS_exit a0
+RISA_API uint64_t risaInstret(const risaHart *hart); // Since risaLoad()
+
+// Architectural state
+RISA_API uint32_t risaGetPc(const risaHart *hart);
+RISA_API void risaSetPc(risaHart *hart, uint32_t pc);
+RISA_API uint32_t risaGetReg(const risaHart *hart, unsigned int index);
+RISA_API void risaSetReg(risaHart *hart, unsigned int index, uint32_t val);
+RISA_API uint8_t *risaMem(risaHart *hart);
+RISA_API uint32_t risaMemSize(const risaHart *hart);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,8 @@ int main(int argc, char **argv) {
         return -1;
     }
     cpu.handlerProcs[RISA_INIT_HANDLER_PROC](&cpu);
-    // Run
-    return executionLoop(&cpu);
+    // Run (cleanup happens here once, whatever stopped the simulation)
+    int err = executionLoop(&cpu);
+    cleanupSimulator(&cpu);
+    return err;
 }
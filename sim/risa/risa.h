@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/utils.h"
+#include "librisa.h"
 
 struct ImmediateFields {
     u32 imm11_0 : 12;
@@ -35,6 +36,7 @@ struct optFlags {
     u32 o_timeout : 1;
     u32 o_intPeriod : 1;
     u32 o_gdbEnabled : 1;
+    u32 o_quiet : 1;
 };
 
 struct GdbFlags {
@@ -52,6 +54,7 @@ struct GdbFields {
 };
 
 struct rv32iHart;
+struct BbvProfile;
 using risa_handler = void (*)(rv32iHart *);
 typedef enum {
     RISA_MMIO_HANDLER_PROC = 0,
@@ -67,6 +70,7 @@ struct rv32iHart {
     u32 regFile[32];
     u32 IF;
     u32 ID;
+    u32 instrLen;
     s32 immFinal;
     s32 immPartial;
     ImmediateFields immFields;
@@ -82,12 +86,33 @@ struct rv32iHart {
     clock_t endTime;
     optFlags opts;
     GdbFields gdbFields;
+    BbvProfile *bbv; // Basic-block vector profile (NULL if disabled)
     LIB_HANDLE handlerLib;
     risa_handler handlerProcs[RISA_HANDLER_PROC_COUNT];
-    void (*cleanupSimulator)(rv32iHart *);
+    risaStopReason stopReason; // Requested stop (see requestStop())
+    int exitCode;              // SYS_exit code (RISA_STOP_EXIT)
     void *handlerData;
 };
 
+// Handlers must not exit() - they request a stop instead, which the
+// execution loop returns at the next instruction boundary (its caller
+// then cleans up)
+inline void requestStop(rv32iHart *cpu, risaStopReason reason,
+                        int exitCode = 0) {
+    cpu->stopReason = reason;
+    cpu->exitCode = exitCode;
+}
+
+// True if the instruction at the PC is inside memory (a compressed one only
+// needs its halfword, e.g. at the very end of memory)
+inline bool fetchInBounds(const rv32iHart *cpu) {
+    if ((size_t)cpu->pc + sizeof(u16) > cpu->virtMemSize) {
+        return false;
+    }
+    return IS_COMPRESSED(ACCESS_MEM_H(cpu->virtMem, cpu->pc)) ||
+           (size_t)cpu->pc + sizeof(u32) <= cpu->virtMemSize;
+}
+
 // Regfile aliases
 typedef enum {
     ZERO,
@@ -132,9 +157,13 @@ void defaultEnvHandler(rv32iHart *cpu);
 void defaultInitHandler(rv32iHart *cpu);
 void defaultExitHandler(rv32iHart *cpu);
 void printHelp(void);
+bool setupHart(rv32iHart *cpu, u32 memSize, u32 intPeriod,
+               const char *handlerLib, bool warnMissing);
+void cleanupHart(rv32iHart *cpu);
 void cleanupSimulator(rv32iHart *cpu);
 bool setupSimulator(int argc, char **argv, rv32iHart *cpu);
 int executionLoop(rv32iHart *cpu);
+int executeInstruction(rv32iHart *cpu);
 
 // Default handlers
 void defaultMmioHandler(rv32iHart *cpu);
@@ -0,0 +1,159 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/utils.h"
+
+#include "flintRV/cosim.h"
+#include "flintRV/flintRV.h"
+
+namespace {
+// Embed the test programs binaries here
+#include "binsearch.inc"
+#include "fibonacci.inc"
+#include "mergesort.inc"
+
+// Synthetic ALU/branch/load-store mix (4096 iterations, ~50K instructions)
+unsigned int mix[] = {
+    0x00000913, // addi s2, zero, 0
+    0x00000993, // addi s3, zero, 0
+    0x00001a37, // lui s4, 0x1
+    0x40000293, // addi t0, zero, 0x400
+    0x01390333, // add t1, s2, s3
+    0x013343b3, // xor t2, t1, s3
+    0x00299e13, // slli t3, s3, 2
+    0x0fce7e13, // andi t3, t3, 0xfc
+    0x005e0e33, // add t3, t3, t0
+    0x007e2023, // sw t2, 0(t3)
+    0x000e2e83, // lw t4, 0(t3)
+    0x01d90933, // add s2, s2, t4
+    0x0019ff13, // andi t5, s3, 1
+    0x000f0463, // beq t5, zero, +8 (taken every other iteration)
+    0x00190913, // addi s2, s2, 1
+    0x00198993, // addi s3, s3, 1
+    0xfd4998e3, // bne s3, s4, -48
+    0x00100073, // ebreak
+};
+unsigned char *mix_hex = (unsigned char *)mix;
+unsigned int mix_hex_len = sizeof(mix);
+} // namespace
+
+// rISA instructions/second (reported as MIPS) running a program to the end
+static void BM_risa(benchmark::State &state, unsigned char *hex,
+                    unsigned int hexLen, int memSize) {
+    std::vector<char> mem(memSize, 0);
+    std::copy(hex, hex + hexLen, mem.begin());
+    uint32_t regs[32] = {0};
+    regs[SP] = regs[FP] = STACK_TOP(memSize);
+    risaRef hart;
+    uint64_t instrs = 0;
+    for (auto _ : state) {
+        if (!hart.sync(mem.data(), mem.size(), regs, 0) ||
+            !hart.fastForward(~(uint64_t)0) || !hart.halted()) {
+            state.SkipWithError("rISA run failed");
+            break;
+        }
+        instrs += hart.instret();
+    }
+    state.counters["MIPS"] =
+        benchmark::Counter(instrs / 1e6, benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_risa, binsearch, binsearch_hex, binsearch_hex_len, 0x4000);
+BENCHMARK_CAPTURE(BM_risa, fibonacci, fibonacci_hex, fibonacci_hex_len, 0x4000);
+BENCHMARK_CAPTURE(BM_risa, mergesort, mergesort_hex, mergesort_hex_len, 0x8000);
+BENCHMARK_CAPTURE(BM_risa, mix, mix_hex, mix_hex_len, 0x1000);
+
+// flintRV harness cycles/second running a program to the end (reinit'd per
+// iteration), optionally dumping a VCD/FST trace
+static void BM_flintRV(benchmark::State &state, unsigned char *hex,
+                       unsigned int hexLen, int memSize, bool trace) {
+    const std::string traceFile = "flintRV_bench.trace";
+    flintRV dut(~(vluint64_t)0, false);
+    if (!dut.create(trace ? traceFile.c_str() : nullptr) ||
+        !dut.createMemory(memSize, hex, hexLen)) {
+        state.SkipWithError("Failed to create flintRV");
+        return;
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        dut.reinit(hex, hexLen);
+        dut.writeRegfile(SP, STACK_TOP(memSize));
+        dut.writeRegfile(FP, STACK_TOP(memSize));
+        if (!dut.run(~(vluint64_t)0)) {
+            state.SkipWithError("flintRV run failed");
+            break;
+        }
+        cycles += dut.cycles();
+    }
+    state.counters["cycles/s"] =
+        benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+    if (trace) {
+        std::remove(traceFile.c_str());
+    }
+}
+BENCHMARK_CAPTURE(BM_flintRV, binsearch, binsearch_hex, binsearch_hex_len,
+                  0x4000, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_flintRV, fibonacci, fibonacci_hex, fibonacci_hex_len,
+                  0x4000, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_flintRV, mergesort, mergesort_hex, mergesort_hex_len,
+                  0x8000, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_flintRV, mix, mix_hex, mix_hex_len, 0x1000, false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_flintRV, mix_traced, mix_hex, mix_hex_len, 0x1000, true)
+    ->Unit(benchmark::kMillisecond);
+
+// Disassembled instructions/second (over all of the program images)
+static void BM_disassembleRv32i(benchmark::State &state) {
+    std::vector<unsigned int> instrs;
+    for (auto image : {std::make_pair(binsearch_hex, binsearch_hex_len),
+                       std::make_pair(fibonacci_hex, fibonacci_hex_len),
+                       std::make_pair(mergesort_hex, mergesort_hex_len),
+                       std::make_pair(mix_hex, mix_hex_len)}) {
+        for (unsigned int i = 0; i + 4 <= image.second; i += 4) {
+            instrs.push_back(*(unsigned int *)&image.first[i]);
+        }
+    }
+    for (auto _ : state) {
+        for (unsigned int instr : instrs) {
+            benchmark::DoNotOptimize(disassembleRv32i(instr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * instrs.size());
+}
+BENCHMARK(BM_disassembleRv32i);
+
+// Program image load bytes/second (from a file of the given size)
+static void BM_loadMem(benchmark::State &state) {
+    const std::string file = "flintRV_bench.hex";
+    std::vector<char> image(state.range(0), 0x13);
+    FILE *f = fopen(file.c_str(), "wb");
+    if (f == nullptr) {
+        state.SkipWithError("Failed to write the image file");
+        return;
+    }
+    fwrite(image.data(), 1, image.size(), f);
+    fclose(f);
+    // loadMem also reads the EOF byte
+    std::vector<char> mem(image.size() + 1);
+    for (auto _ : state) {
+        if (!loadMem(file, mem.data(), mem.size())) {
+            state.SkipWithError("loadMem failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * image.size());
+    std::remove(file.c_str());
+}
+BENCHMARK(BM_loadMem)->Arg(0x8000)->Arg(0x100000);
+
+BENCHMARK_MAIN();
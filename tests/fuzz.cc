@@ -0,0 +1,205 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "flintRV/fuzz.h"
+
+#include "common/utils.h"
+
+#include "miniargparse/miniargparse.h"
+
+#define PROGRESS_INTERVAL 10 // Seconds between progress prints
+
+namespace {
+std::atomic<uint64_t> g_nextSeed(0);
+std::atomic<uint64_t> g_runs(0);
+std::atomic<uint64_t> g_failures(0);
+std::atomic<int> g_workers(0);
+std::atomic<bool> g_stop(false);
+std::mutex g_printLock;
+
+bool writeInput(const std::string &path, const std::vector<uint8_t> &input) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(input.data(), 1, input.size(), f) == input.size();
+    fclose(f);
+    return ok;
+}
+
+bool readInput(const std::string &path, std::vector<uint8_t> &input) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    uint8_t buf[4096];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        input.insert(input.end(), buf, buf + n);
+    }
+    fclose(f);
+    return true;
+}
+
+// Runs seeds (claimed from g_nextSeed) until lastSeed or g_stop, saving the
+// input of each failing one to outDir
+void fuzzWorker(uint64_t lastSeed, std::string outDir) {
+    flintRVFuzzer fuzzer;
+    std::string report;
+    while (!g_stop) {
+        uint64_t seed = g_nextSeed++;
+        if (seed >= lastSeed) {
+            break;
+        }
+        std::vector<uint8_t> input = fuzzSeedInput(seed);
+        if (!fuzzer.run(fuzzGenerate(input.data(), input.size()), report)) {
+            std::string path =
+                outDir + "/fuzz-" + std::to_string(seed) + ".bin";
+            bool saved = writeInput(path, input);
+            std::lock_guard<std::mutex> lock(g_printLock);
+            LOG_ERROR_PRINTF("Seed %" PRIu64 " failed (input: %s):", seed,
+                             saved ? path.c_str() : "not saved");
+            printf("%s", report.c_str());
+            fflush(stdout);
+            g_failures++;
+        }
+        g_runs++;
+    }
+    g_workers--;
+}
+
+// Re-runs one input w/ the per-instruction check (i.e. a saved failure or
+// libFuzzer crash file), printing the program
+int replay(const char *file) {
+    std::vector<uint8_t> input;
+    if (!readInput(file, input)) {
+        LOG_ERROR_PRINTF("Failed to read fuzz input: %s", file);
+        return 1;
+    }
+    flintRVFuzzProgram prog = fuzzGenerate(input.data(), input.size());
+    printf("%s", fuzzListing(prog).c_str());
+    flintRVFuzzer fuzzer;
+    std::string report;
+    if (!fuzzer.run(prog, report, true)) {
+        printf("%s", report.c_str());
+        return 1;
+    }
+    LOG_INFO("Final regfile/memory match.");
+    return 0;
+}
+} // namespace
+
+void printHelp(void) {
+    printf("[Usage]: flintRV_fuzz [OPTIONS]\n\n"
+           "OPTIONS:\n");
+    miniargparsePrint();
+}
+
+int main(int argc, char *argv[]) {
+    // Define opts
+    MINIARGPARSE_OPT(help, "h", "help", 0, "Print help and exit.");
+    MINIARGPARSE_OPT(jobs, "j", "jobs", 1,
+                     "Worker threads [DEFAULT=hardware threads].");
+    MINIARGPARSE_OPT(seed, "s", "seed", 1, "First seed [DEFAULT=0].");
+    MINIARGPARSE_OPT(runs, "r", "runs", 1,
+                     "Programs to run [DEFAULT=0, i.e. until stopped].");
+    MINIARGPARSE_OPT(seconds, "t", "time", 1,
+                     "Stop after this many seconds [DEFAULT=Disabled].");
+    MINIARGPARSE_OPT(outDir, "o", "outDir", 1,
+                     "Directory failing inputs are saved to [DEFAULT=.].");
+    MINIARGPARSE_OPT(replayFile, "", "replay", 1,
+                     "Re-run a saved failing input (or libFuzzer crash "
+                     "file), checking each retired instruction.");
+
+    // Parse the args
+    int unknownOpt = miniargparseParse(argc, argv);
+    if (unknownOpt > 0) {
+        LOG_ERROR_PRINTF("Unknown option ( %s ) used.", argv[unknownOpt]);
+        printHelp();
+        return 1;
+    }
+    if (help.infoBits.used) {
+        printHelp();
+        return 0;
+    }
+
+    // Check if any option had an error
+    miniargparseOpt *tmp = miniargparseOptlistController(NULL);
+    while (tmp != NULL) {
+        if (tmp->infoBits.hasErr) {
+            LOG_ERROR_PRINTF("%s ( Option: %s )", tmp->errValMsg,
+                             argv[tmp->index]);
+            printHelp();
+            return 1;
+        }
+        tmp = tmp->next;
+    }
+    if (replayFile.infoBits.used) {
+        return replay(replayFile.value);
+    }
+
+    // Get value items
+    int jobCount = (int)std::thread::hardware_concurrency();
+    if (jobs.infoBits.used) {
+        jobCount = atoi(jobs.value);
+    }
+    jobCount = std::max(jobCount, 1);
+#if !FLINTRV_HAS_CONTEXT
+    if (jobCount > 1) {
+        // Models share the global Verilated state before v4.202
+        LOG_WARNING("Verilator is older than v4.202, using 1 job.");
+        jobCount = 1;
+    }
+#endif
+    uint64_t firstSeed = seed.infoBits.used ? strtoull(seed.value, NULL, 0) : 0;
+    uint64_t runCount = runs.infoBits.used ? strtoull(runs.value, NULL, 0) : 0;
+    uint64_t lastSeed = (runCount == 0) ? ~(uint64_t)0 : firstSeed + runCount;
+    double timeLimit = seconds.infoBits.used ? atof(seconds.value) : 0.0;
+    std::string dir = outDir.infoBits.used ? outDir.value : ".";
+
+    LOG_INFO_PRINTF("Fuzzing w/ %d jobs from seed %" PRIu64 "...", jobCount,
+                    firstSeed);
+    g_nextSeed = firstSeed;
+    g_workers = jobCount;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < jobCount; ++i) {
+        workers.emplace_back(fuzzWorker, lastSeed, dir);
+    }
+    auto start = std::chrono::steady_clock::now();
+    double nextProgress = PROGRESS_INTERVAL;
+    while (g_workers > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        double elapsed = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        if (timeLimit > 0.0 && elapsed >= timeLimit) {
+            g_stop = true;
+        }
+        if (elapsed >= nextProgress) {
+            std::lock_guard<std::mutex> lock(g_printLock);
+            LOG_INFO_PRINTF("%" PRIu64 " programs, %" PRIu64
+                            " failures, %.1f programs/s",
+                            (uint64_t)g_runs, (uint64_t)g_failures,
+                            g_runs / elapsed);
+            nextProgress += PROGRESS_INTERVAL;
+        }
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    LOG_INFO_PRINTF("Done: %" PRIu64 " programs, %" PRIu64 " failures.",
+                    (uint64_t)g_runs, (uint64_t)g_failures);
+    return (g_failures == 0) ? 0 : 1;
+}
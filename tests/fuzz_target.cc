@@ -0,0 +1,22 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "flintRV/fuzz.h"
+
+// libFuzzer entry point - a mismatch aborts (i.e. is reported as a crash,
+// which flintRV_fuzz --replay can re-run)
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static flintRVFuzzer fuzzer;
+    std::string report;
+    flintRVFuzzProgram prog = fuzzGenerate(data, size);
+    if (!fuzzer.run(prog, report)) {
+        printf("%s%s", fuzzListing(prog).c_str(), report.c_str());
+        fflush(stdout);
+        abort();
+    }
+    return 0;
+}
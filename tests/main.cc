@@ -4,12 +4,192 @@
 #include "flintRV/flintRV.h"
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // _WIN32
+
 bool g_testTracing = false;
 
+#ifndef _WIN32
+namespace {
+// Per-test result of a worker process
+struct TestRun {
+    std::string name;
+    std::string outFile; // Captured stdout/stderr
+    std::string resFile; // Recorded "cycles" property
+    std::chrono::steady_clock::time_point start;
+    double wallTime = 0.0;
+    std::string cycles = "-";
+    bool passed = false;
+};
+
+// Writes the "cycles" property of the test a worker ran to resFile
+class CyclesListener : public ::testing::EmptyTestEventListener {
+  public:
+    explicit CyclesListener(std::string resFile) : m_resFile(resFile) {}
+    void OnTestEnd(const ::testing::TestInfo &info) override {
+        const ::testing::TestResult *result = info.result();
+        for (int i = 0; i < result->test_property_count(); ++i) {
+            const ::testing::TestProperty &prop = result->GetTestProperty(i);
+            if (std::string(prop.key()) == "cycles") {
+                std::ofstream(m_resFile) << prop.value();
+            }
+        }
+    }
+
+  private:
+    std::string m_resFile;
+};
+
+std::string tempFile() {
+    char path[] = "/tmp/flintRV_testsXXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+    }
+    return path;
+}
+
+std::string readFile(const std::string &path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// Forks a worker that runs the gtest filter w/ its output captured to outFile
+pid_t forkWorker(const std::string &filter, const std::string &outFile,
+                 const std::string &resFile, bool listTests) {
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    FILE *out = fopen(outFile.c_str(), "w");
+    if (out == nullptr) {
+        _exit(1);
+    }
+    dup2(fileno(out), STDOUT_FILENO);
+    dup2(fileno(out), STDERR_FILENO);
+    ::testing::GTEST_FLAG(filter) = filter;
+    ::testing::GTEST_FLAG(list_tests) = listTests;
+    ::testing::GTEST_FLAG(output) = "";
+    ::testing::UnitTest::GetInstance()->listeners().Append(
+        new CyclesListener(resFile));
+    int rc = RUN_ALL_TESTS();
+    fflush(stdout);
+    fflush(stderr);
+    _exit(rc);
+}
+
+// Lists the tests matching the current --gtest_filter
+std::vector<std::string> listTests() {
+    std::vector<std::string> tests;
+    std::string outFile = tempFile();
+    int status = 0;
+    waitpid(forkWorker(::testing::GTEST_FLAG(filter), outFile, "/dev/null",
+                       true),
+            &status, 0);
+    std::istringstream list(readFile(outFile));
+    std::remove(outFile.c_str());
+    std::string line, suite;
+    while (std::getline(list, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        // "Suite." lines, followed by indented "  Name" lines
+        if (line[0] != ' ') {
+            suite = line.substr(0, line.find_first_of(" #"));
+        } else {
+            size_t end = line.find_first_of(" #", 2);
+            tests.push_back(suite + line.substr(2, end - 2));
+        }
+    }
+    return tests;
+}
+
+// Runs each test in its own worker process, jobs at a time. Output of each
+// test is printed as a whole once it finishes, followed by a summary.
+int runParallel(int jobs) {
+    std::vector<std::string> tests = listTests();
+    std::vector<TestRun> runs(tests.size());
+    std::map<pid_t, size_t> running;
+    size_t next = 0, failed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    while (next < tests.size() || !running.empty()) {
+        // Fill free worker slots
+        while (next < tests.size() && (int)running.size() < jobs) {
+            TestRun &run = runs[next];
+            run.name = tests[next];
+            run.outFile = tempFile();
+            run.resFile = tempFile();
+            run.start = std::chrono::steady_clock::now();
+            pid_t pid = forkWorker(run.name, run.outFile, run.resFile, false);
+            if (pid < 0) {
+                fprintf(stderr, "Failed to fork a test worker!\n");
+                return 1;
+            }
+            running[pid] = next++;
+        }
+        // Reap a finished worker
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0 || running.count(pid) == 0) {
+            continue;
+        }
+        TestRun &run = runs[running[pid]];
+        running.erase(pid);
+        run.wallTime = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - run.start)
+                           .count();
+        run.passed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        std::string cycles = readFile(run.resFile);
+        run.cycles = cycles.empty() ? "-" : cycles;
+        failed += run.passed ? 0 : 1;
+        printf("%s", readFile(run.outFile).c_str());
+        fflush(stdout);
+        std::remove(run.outFile.c_str());
+        std::remove(run.resFile.c_str());
+    }
+
+    double wallTime = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    printf("\n[ SUMMARY ] %zu tests, %d jobs, %.3f s wall time\n",
+           runs.size(), jobs, wallTime);
+    printf("%-8s %-48s %14s %12s\n", "result", "test", "cycles", "wall (s)");
+    for (const TestRun &run : runs) {
+        printf("%-8s %-48s %14s %12.3f\n", run.passed ? "PASSED" : "FAILED",
+               run.name.c_str(), run.cycles.c_str(), run.wallTime);
+    }
+    printf("[ SUMMARY ] %zu passed, %zu failed\n", runs.size() - failed,
+           failed);
+    return (failed == 0) ? 0 : 1;
+}
+} // namespace
+#endif // _WIN32
+
 int main(int argc, char *argv[]) {
+    int jobs = 1;
     // Parse any passed option(s)
     for (int i = 0; i < argc; ++i) {
         std::string s(argv[i]);
+        if (s == "-j" && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+            continue;
+        }
         if (s.find("-v") != std::string::npos) {
             printf("%s\n", flintRV_VERSION);
             return 0;
@@ -18,6 +198,8 @@ int main(int argc, char *argv[]) {
             printf("%s\n", "flintRV_tests option(s):\n"
                            "    -h             : Prints help and exits\n"
                            "    -v             : Prints version and exits\n"
+                           "    -j <N>         : Runs N tests at a time (in "
+                           "worker processes)\n"
                            "    --tracing      : Prints disassembled "
                            "instructions + CPU state\n");
             return 0;
@@ -27,5 +209,10 @@ int main(int argc, char *argv[]) {
         }
     }
     testing::InitGoogleTest(&argc, argv);
+#ifndef _WIN32
+    if (jobs > 1) {
+        return runParallel(jobs);
+    }
+#endif // _WIN32
     return RUN_ALL_TESTS();
 }
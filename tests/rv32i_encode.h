@@ -0,0 +1,66 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#pragma once
+
+#include <cstdint>
+
+// Hand-encoded RV32I instructions (for tests that run w/o the toolchain)
+namespace rv32i {
+inline uint32_t rType(uint32_t funct7, uint32_t rs2, uint32_t rs1,
+                      uint32_t funct3, uint32_t rd, uint32_t opcode) {
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+           (rd << 7) | opcode;
+}
+inline uint32_t iType(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd,
+                      uint32_t opcode) {
+    return (((uint32_t)imm & 0xfff) << 20) | (rs1 << 15) | (funct3 << 12) |
+           (rd << 7) | opcode;
+}
+inline uint32_t sType(int32_t imm, uint32_t rs2, uint32_t rs1,
+                      uint32_t funct3) {
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 5) & 0x7f) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (funct3 << 12) | ((u & 0x1f) << 7) | 0x23;
+}
+inline uint32_t bType(int32_t imm, uint32_t rs2, uint32_t rs1,
+                      uint32_t funct3) {
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 12) & 0x1) << 31) | (((u >> 5) & 0x3f) << 25) |
+           (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+           (((u >> 1) & 0xf) << 8) | (((u >> 11) & 0x1) << 7) | 0x63;
+}
+
+inline uint32_t add(uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return rType(0x00, rs2, rs1, 0x0, rd, 0x33);
+}
+inline uint32_t addi(uint32_t rd, uint32_t rs1, int32_t imm) {
+    return iType(imm, rs1, 0x0, rd, 0x13);
+}
+inline uint32_t lw(uint32_t rd, uint32_t rs1, int32_t imm) {
+    return iType(imm, rs1, 0x2, rd, 0x03);
+}
+inline uint32_t lbu(uint32_t rd, uint32_t rs1, int32_t imm) {
+    return iType(imm, rs1, 0x4, rd, 0x03);
+}
+inline uint32_t sw(uint32_t rs2, uint32_t rs1, int32_t imm) {
+    return sType(imm, rs2, rs1, 0x2);
+}
+inline uint32_t sb(uint32_t rs2, uint32_t rs1, int32_t imm) {
+    return sType(imm, rs2, rs1, 0x0);
+}
+inline uint32_t beq(uint32_t rs1, uint32_t rs2, int32_t imm) {
+    return bType(imm, rs2, rs1, 0x0);
+}
+inline uint32_t bne(uint32_t rs1, uint32_t rs2, int32_t imm) {
+    return bType(imm, rs2, rs1, 0x1);
+}
+inline uint32_t jal(uint32_t rd, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 20) & 0x1) << 31) | (((u >> 1) & 0x3ff) << 21) |
+           (((u >> 11) & 0x1) << 20) | (((u >> 12) & 0xff) << 12) |
+           (rd << 7) | 0x6f;
+}
+inline uint32_t ecall() { return 0x00000073; }
+inline uint32_t ebreak() { return 0x00100073; }
+} // namespace rv32i
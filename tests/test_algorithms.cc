@@ -5,7 +5,9 @@
 #include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <verilated.h>
 #include <verilated_vcd_c.h>
@@ -22,18 +24,38 @@ namespace {
 #include "binsearch.inc"
 #include "fibonacci.inc"
 #include "mergesort.inc"
-} // namespace
-
-extern int g_testTracing;
+// CoreMark/Dhrystone-style workloads (tests/workloads)
+#include "coremark_lite.inc"
+#include "dhrystone_lite.inc"
+#ifdef FLINTRV_RV32C
+#include "binsearch_c.inc"
+#include "fibonacci_c.inc"
+#include "mergesort_c.inc"
+#endif // FLINTRV_RV32C
+
+// Report cycle, retired instruction, branch prediction and load-use counts
+// (shows up in --gtest_output XML)
+void recordPerfStats(flintRV &dut) {
+    const flintRVPerf &perf = dut.perf();
+    ::testing::Test::RecordProperty("cycles", std::to_string(dut.cycles()));
+    ::testing::Test::RecordProperty("retired", std::to_string(perf.retired));
+    ::testing::Test::RecordProperty("branches", std::to_string(perf.branches));
+    ::testing::Test::RecordProperty("mispredicts",
+                                    std::to_string(perf.mispredicts));
+    ::testing::Test::RecordProperty("load_uses",
+                                    std::to_string(perf.loadUses));
+    ::testing::Test::RecordProperty("load_use_stalls",
+                                    std::to_string(perf.loadUseStalls));
+}
 
-TEST(algorithms, fibonacci) {
-    constexpr int memSize = 0x4000;
-    flintRV dut = flintRV(1000000, g_testTracing);
-    if (!dut.create(new VflintRV(), nullptr)) {
-        FAIL();
+// Load a test program and run it until exit (false on any harness error)
+bool loadAndRun(flintRV &dut, int memSize, unsigned char *hex,
+                unsigned int hexLen) {
+    if (!dut.create()) {
+        return false;
     }
-    if (!dut.createMemory(memSize, fibonacci_hex, fibonacci_hex_len)) {
-        FAIL();
+    if (!dut.createMemory(memSize, hex, hexLen)) {
+        return false;
     }
 
     dut.m_cpu->i_ifValid = 1;  // Always valid since we assume combinatorial
@@ -41,20 +63,24 @@ TEST(algorithms, fibonacci) {
     dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
                                // read/write for test memory
     // Init stack and frame pointers
-    dut.writeRegfile(SP, memSize - 1);
-    dut.writeRegfile(FP, memSize - 1);
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
 
-    while (!dut.end()) {
-        if (!dut.instructionUpdate()) {
-            FAIL();
-        }
-        if (!dut.loadStoreUpdate()) {
-            FAIL();
-        }
-        dut.tick(); // Evaluate
+    return dut.run(~(vluint64_t)0);
+}
+
+// Same as loadAndRun, also recording the perf stats
+bool runProgram(flintRV &dut, int memSize, unsigned char *hex,
+                unsigned int hexLen) {
+    dut.setPerf(true);
+    if (!loadAndRun(dut, memSize, hex, hexLen)) {
+        return false;
     }
+    recordPerfStats(dut);
+    return true;
+}
 
-    // Check results
+void checkFibonacci(flintRV &dut) {
     std::function<int(int)> fibonacci = [&](int x) {
         if (x <= 1) {
             return x;
@@ -68,70 +94,14 @@ TEST(algorithms, fibonacci) {
     EXPECT_EQ(dut.readRegfile(S10), fibonacci(10));
 }
 
-TEST(algorithms, binsearch) {
-    constexpr int memSize = 0x4000;
-    flintRV dut = flintRV(1000000, g_testTracing);
-    if (!dut.create(new VflintRV(), nullptr)) {
-        FAIL();
-    }
-    if (!dut.createMemory(memSize, binsearch_hex, binsearch_hex_len)) {
-        FAIL();
-    }
-
-    dut.m_cpu->i_ifValid = 1;  // Always valid since we assume combinatorial
-                               // read/write for test memory
-    dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
-                               // read/write for test memory
-    // Init stack and frame pointers
-    dut.writeRegfile(SP, memSize - 1);
-    dut.writeRegfile(FP, memSize - 1);
-
-    while (!dut.end()) {
-        if (!dut.instructionUpdate()) {
-            FAIL();
-        }
-        if (!dut.loadStoreUpdate()) {
-            FAIL();
-        }
-        dut.tick(); // Evaluate
-    }
-
-    // Check results
+void checkBinsearch(flintRV &dut) {
     EXPECT_EQ(dut.readRegfile(S1), 1); // Testing valid binsearch result
     EXPECT_EQ(dut.readRegfile(S2), 1); // Testing valid binsearch result
     EXPECT_EQ(dut.readRegfile(S3), 1); // Testing valid binsearch result
     EXPECT_EQ(dut.readRegfile(S4), 0); // Testing invalid binsearch result
 }
 
-TEST(algorithms, mergesort) {
-    constexpr int memSize = 0x8000;
-    flintRV dut = flintRV(1000000, g_testTracing);
-    if (!dut.create(new VflintRV(), nullptr)) {
-        FAIL();
-    }
-    if (!dut.createMemory(memSize, mergesort_hex, mergesort_hex_len)) {
-        FAIL();
-    }
-
-    dut.m_cpu->i_ifValid = 1;  // Always valid since we assume combinatorial
-                               // read/write for test memory
-    dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
-                               // read/write for test memory
-    // Init stack and frame pointers
-    dut.writeRegfile(SP, memSize - 1);
-    dut.writeRegfile(FP, memSize - 1);
-
-    while (!dut.end()) {
-        if (!dut.instructionUpdate()) {
-            FAIL();
-        }
-        if (!dut.loadStoreUpdate()) {
-            FAIL();
-        }
-        dut.tick(); // Evaluate
-    }
-
-    // Check results
+void checkMergesort(flintRV &dut) {
     int arrLen = dut.readRegfile(S8);
     int origArr = dut.readRegfile(S9);
     int sortedArr = dut.readRegfile(S10);
@@ -142,3 +112,92 @@ TEST(algorithms, mergesort) {
         EXPECT_EQ(goldVal, actualVal);
     }
 }
+} // namespace
+
+extern int g_testTracing;
+
+TEST(algorithms, fibonacci) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(runProgram(dut, 0x4000, fibonacci_hex, fibonacci_hex_len));
+    checkFibonacci(dut);
+}
+
+TEST(algorithms, binsearch) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(runProgram(dut, 0x4000, binsearch_hex, binsearch_hex_len));
+    checkBinsearch(dut);
+}
+
+TEST(algorithms, mergesort) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(runProgram(dut, 0x8000, mergesort_hex, mergesort_hex_len));
+    checkMergesort(dut);
+}
+
+// Iteration count/checksum of the default (ITERATIONS) builds
+TEST(algorithms, coremark_lite) {
+    flintRV dut = flintRV(10000000, g_testTracing);
+    ASSERT_TRUE(
+        runProgram(dut, 0x8000, coremark_lite_hex, coremark_lite_hex_len));
+    EXPECT_EQ(dut.readRegfile(S1), 10);
+    EXPECT_EQ(dut.readRegfile(S2), 0x4ba5);
+}
+
+TEST(algorithms, dhrystone_lite) {
+    flintRV dut = flintRV(10000000, g_testTracing);
+    ASSERT_TRUE(
+        runProgram(dut, 0x8000, dhrystone_lite_hex, dhrystone_lite_hex_len));
+    EXPECT_EQ(dut.readRegfile(S1), 500);
+    EXPECT_EQ((unsigned int)dut.readRegfile(S2), 0xee10ab32u);
+}
+
+#if FLINTRV_HAS_CONTEXT
+// Independent harness instances simulating concurrently on their own threads
+TEST(algorithms, mergesort_concurrent) {
+    constexpr int INSTANCES = 4;
+    std::vector<std::unique_ptr<flintRV>> duts;
+    std::vector<std::thread> workers;
+    std::vector<char> passed(INSTANCES, 0);
+    for (int i = 0; i < INSTANCES; ++i) {
+        duts.emplace_back(new flintRV(1000000, false));
+    }
+    for (int i = 0; i < INSTANCES; ++i) {
+        workers.emplace_back([&, i]() {
+            passed[i] =
+                loadAndRun(*duts[i], 0x8000, mergesort_hex, mergesort_hex_len);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (int i = 0; i < INSTANCES; ++i) {
+        ASSERT_TRUE(passed[i]);
+        checkMergesort(*duts[i]);
+        EXPECT_EQ(duts[i]->cycles(), duts[0]->cycles());
+    }
+}
+#endif // FLINTRV_HAS_CONTEXT
+
+#ifdef FLINTRV_RV32C
+// Same programs built w/ -march=rv32ic (compare cycles against the above)
+TEST(algorithms, fibonacci_rvc) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(
+        runProgram(dut, 0x4000, fibonacci_c_hex, fibonacci_c_hex_len));
+    checkFibonacci(dut);
+}
+
+TEST(algorithms, binsearch_rvc) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(
+        runProgram(dut, 0x4000, binsearch_c_hex, binsearch_c_hex_len));
+    checkBinsearch(dut);
+}
+
+TEST(algorithms, mergesort_rvc) {
+    flintRV dut = flintRV(1000000, g_testTracing);
+    ASSERT_TRUE(
+        runProgram(dut, 0x8000, mergesort_c_hex, mergesort_c_hex_len));
+    checkMergesort(dut);
+}
+#endif // FLINTRV_RV32C
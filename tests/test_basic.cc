@@ -15,6 +15,9 @@
 #include "common/utils.h"
 
 #include "flintRV/flintRV.h"
+#include "flintRV/sampling.h"
+
+#include "rv32i_encode.h"
 
 namespace {
 // Embed the test programs binaries here
@@ -26,7 +29,7 @@ extern int g_testTracing;
 TEST(basic, functions) {
     constexpr int memSize = 0x80000;
     flintRV dut = flintRV(1000000, g_testTracing);
-    if (!dut.create(new VflintRV(), nullptr)) {
+    if (!dut.create()) {
         FAIL();
     }
     if (!dut.createMemory(memSize, functions_hex, functions_hex_len)) {
@@ -38,18 +41,45 @@ TEST(basic, functions) {
     dut.m_cpu->i_memValid = 1; // Always valid since we assume combinatorial
                                // read/write for test memory
     // Init stack and frame pointers
-    dut.writeRegfile(SP, memSize - 1);
-    dut.writeRegfile(FP, memSize - 1);
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+
+    if (!dut.run(~(vluint64_t)0)) {
+        FAIL();
+    }
+    RecordProperty("cycles", std::to_string(dut.cycles()));
+
+    EXPECT_EQ(dut.readRegfile(S1), 6);
+    EXPECT_EQ(dut.readRegfile(S2), 720);
+    EXPECT_EQ(dut.readRegfile(S3), 362880);
+    EXPECT_EQ(dut.readRegfile(S4), 15);
+    EXPECT_EQ(dut.readRegfile(S5), 1);
+    EXPECT_EQ(dut.readRegfile(S6), 1);
+    EXPECT_EQ(dut.readRegfile(S7), 0);
+}
+
+TEST(basic, functions_batched) {
+    constexpr int memSize = 0x80000;
+    flintRV dut = flintRV(1000000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(memSize, functions_hex, functions_hex_len)) {
+        FAIL();
+    }
 
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+
+    // Same program, run in small batches
     while (!dut.end()) {
-        if (!dut.instructionUpdate()) {
-            FAIL();
-        }
-        if (!dut.loadStoreUpdate()) {
+        vluint64_t start = dut.cycles();
+        if (!dut.run(7)) {
             FAIL();
         }
-        // Evaluate
-        dut.tick();
+        EXPECT_LE(dut.cycles() - start, 8u); // +1 for the final drain
     }
 
     EXPECT_EQ(dut.readRegfile(S1), 6);
@@ -60,3 +90,285 @@ TEST(basic, functions) {
     EXPECT_EQ(dut.readRegfile(S6), 1);
     EXPECT_EQ(dut.readRegfile(S7), 0);
 }
+
+TEST(basic, functions_reinit) {
+    constexpr int memSize = 0x80000;
+    flintRVPool pool;
+    vluint64_t firstCycles = 0;
+    // 2nd run reuses the harness - must match the fresh 1st run
+    for (int i = 0; i < 2; ++i) {
+        flintRV *dut = pool.acquire(memSize, functions_hex,
+                                    functions_hex_len, 1000000, g_testTracing);
+        ASSERT_NE(dut, nullptr);
+        dut->m_cpu->i_ifValid = 1;
+        dut->m_cpu->i_memValid = 1;
+        dut->writeRegfile(SP, STACK_TOP(memSize));
+        dut->writeRegfile(FP, STACK_TOP(memSize));
+        ASSERT_TRUE(dut->run(~(vluint64_t)0));
+
+        EXPECT_EQ(dut->readRegfile(S1), 6);
+        EXPECT_EQ(dut->readRegfile(S2), 720);
+        EXPECT_EQ(dut->readRegfile(S3), 362880);
+        EXPECT_EQ(dut->readRegfile(S4), 15);
+        EXPECT_EQ(dut->readRegfile(S5), 1);
+        EXPECT_EQ(dut->readRegfile(S6), 1);
+        EXPECT_EQ(dut->readRegfile(S7), 0);
+        if (i == 0) {
+            firstCycles = dut->cycles();
+        } else {
+            EXPECT_EQ(dut->cycles(), firstCycles);
+        }
+    }
+}
+
+TEST(basic, functions_cosim) {
+    constexpr int memSize = 0x80000;
+    flintRV dut = flintRV(1000000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(memSize, functions_hex, functions_hex_len)) {
+        FAIL();
+    }
+
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+    dut.setCosim(true);
+
+    EXPECT_TRUE(dut.run(~(vluint64_t)0));
+    EXPECT_FALSE(dut.cosimMismatch());
+    EXPECT_EQ(dut.readRegfile(S3), 362880);
+}
+
+TEST(basic, cosim_mismatch) {
+    // Sums 0..9 (i.e. loops until s3 == s4)
+    unsigned int program[] = {
+        0x00000993, // addi s3, zero, 0
+        0x00000913, // addi s2, zero, 0
+        0x00a00a13, // addi s4, zero, 10
+        0x01298933, // add s2, s3, s2
+        0x00198993, // addi s3, s3, 1
+        0xff499ce3, // bne s3, s4, -8
+        0x00100a93, // addi s5, zero, 1
+        0x00200b13, // addi s6, zero, 2
+        0x00100073, // ebreak
+    };
+    flintRV dut = flintRV(10000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(0x1000, (unsigned char *)program,
+                          sizeof(program))) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.setCosim(true);
+
+    // Cut the loop short on the RTL only (after s4 is written)
+    ASSERT_TRUE(dut.run(12));
+    dut.writeRegfile(S4, 5);
+    EXPECT_FALSE(dut.run(~(vluint64_t)0));
+    EXPECT_TRUE(dut.cosimMismatch());
+    EXPECT_EQ(dut.readRegfile(S3), 5);
+}
+
+TEST(basic, misaligned) {
+    using namespace rv32i;
+    std::vector<uint32_t> program = {
+        addi(1, 0, 0x5a),
+        sb(1, 0, 0x101),  // Byte accesses may use any lane
+        lbu(2, 0, 0x101),
+        lw(3, 0, 0x102),  // Misaligned word
+        ebreak(),
+    };
+    flintRV dut = flintRV(10000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(0x1000, (unsigned char *)program.data(),
+                          program.size() * sizeof(uint32_t))) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    EXPECT_FALSE(dut.run(~(vluint64_t)0));
+    int word = 0;
+    ASSERT_TRUE(dut.peekMem(0x100, word));
+    EXPECT_EQ(word, 0x5a00);
+}
+
+TEST(basic, fetch_bounds) {
+    constexpr int memSize = 0x1000;
+    flintRV dut = flintRV(10000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(memSize)) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    // The last word is fetchable (i.e. the EBREAK ends the run in EXEC)
+    ASSERT_TRUE(dut.pokeMem(memSize - 12, (int)rv32i::ebreak()));
+    ASSERT_TRUE(dut.pokeMem(memSize - 8, (int)rv32i::addi(0, 0, 0)));
+    ASSERT_TRUE(dut.pokeMem(memSize - 4, (int)rv32i::addi(0, 0, 0)));
+    dut.restartAt(memSize - 12);
+    EXPECT_TRUE(dut.run(~(vluint64_t)0));
+    // A fetch must not read past the end of memory
+    dut.restartAt(memSize - 2);
+    EXPECT_FALSE(dut.run(~(vluint64_t)0));
+#ifdef FLINTRV_RV32C
+    // ...but a compressed instruction fits in the last halfword
+    ASSERT_TRUE(dut.pokeMem(memSize - 2, 0x0001)); // c.nop
+    dut.restartAt(memSize - 2);
+    EXPECT_TRUE(dut.run(1));
+    ASSERT_TRUE(dut.pokeMem(memSize - 2, 0x0013)); // 1st half of a 32b addi
+    dut.restartAt(memSize - 2);
+    EXPECT_FALSE(dut.run(1));
+#endif // FLINTRV_RV32C
+}
+
+TEST(basic, perf_counters) {
+    using namespace rv32i;
+    // 38 instructions retire before the EBREAK: a 10 iteration loop (bne
+    // taken 9x), one load-use pair and one load w/ an independent
+    // instruction in between (forwarded from WB, no stall)
+    std::vector<uint32_t> program = {
+        addi(1, 0, 0),    // x1 = 0
+        addi(2, 0, 10),   // x2 = 10
+        add(1, 1, 2),     // loop: x1 += x2
+        addi(2, 2, -1),   // x2 -= 1
+        bne(2, 0, -8),    // -> loop
+        sw(1, 0, 0x100),  // [0x100] = 55
+        lw(3, 0, 0x100),  // x3 = [0x100]
+        add(4, 3, 3),     // Load-use
+        lw(5, 0, 0x100),  // x5 = [0x100]
+        addi(6, 0, 1),    // (rs2 field is imm[4:0], i.e. not x5)
+        add(7, 5, 6),     // x7 = x5 + x6
+        ebreak(),
+        addi(0, 0, 0), // Fetched but never executed
+        addi(0, 0, 0),
+    };
+    constexpr vluint64_t RETIRED = 38;
+    constexpr vluint64_t FILL_DRAIN = 4; // i.e. the EBREAK's WB slot
+#ifdef FLINTRV_BRANCH_PREDICTOR
+    // BTB miss on the 1st taken bne, then the loop exit (predicted taken)
+    constexpr vluint64_t MISPREDICTS = 2;
+#else
+    constexpr vluint64_t MISPREDICTS = 9; // Every taken bne
+#endif // FLINTRV_BRANCH_PREDICTOR
+#ifdef FLINTRV_EARLY_BRANCH
+    constexpr vluint64_t REDIRECT_SLOTS = 2; // Fetch + decode
+#else
+    constexpr vluint64_t REDIRECT_SLOTS = 3; // Fetch + decode + EXEC
+#endif // FLINTRV_EARLY_BRANCH
+#ifdef FLINTRV_LOAD_FWD
+    constexpr vluint64_t LOAD_USE_STALLS = 0;
+#else
+    constexpr vluint64_t LOAD_USE_STALLS = 1;
+#endif // FLINTRV_LOAD_FWD
+    flintRV dut = flintRV(10000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(0x1000, (unsigned char *)program.data(),
+                          program.size() * sizeof(uint32_t))) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.setPerf(true);
+    ASSERT_TRUE(dut.run(~(vluint64_t)0));
+    EXPECT_EQ(dut.readRegfile(1), 55);
+    EXPECT_EQ(dut.readRegfile(4), 110);
+    EXPECT_EQ(dut.readRegfile(7), 56);
+
+    const flintRVPerf &perf = dut.perf();
+    EXPECT_EQ(perf.retired, RETIRED);
+    EXPECT_EQ(perf.branches, 10u);
+    EXPECT_EQ(perf.mispredicts, MISPREDICTS);
+    EXPECT_EQ(perf.loadUses, 1u);
+    EXPECT_EQ(perf.loadUseStalls, LOAD_USE_STALLS);
+    EXPECT_EQ(perf.flushedSlots, MISPREDICTS * REDIRECT_SLOTS);
+    EXPECT_EQ(perf.loadWaitStalls, 0u);
+    EXPECT_EQ(perf.storeWaitStalls, 0u);
+    EXPECT_EQ(perf.mulDivStalls, 0u);
+    EXPECT_EQ(perf.fetchStalls, 0u);
+    // Every cycle is a retirement, an attributed lost cycle or fill/drain
+    EXPECT_EQ(perf.cycles, perf.retired + perf.loadUseStalls +
+                               perf.flushedSlots + FILL_DRAIN);
+}
+
+TEST(basic, functions_sampled) {
+    constexpr int memSize = 0x80000;
+    flintRV dut = flintRV(1000000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(memSize, functions_hex, functions_hex_len)) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+    dut.setCosim(true); // Checks the handed-off state
+
+    // Hand off mid-program, then finish it on the RTL in one window
+    flintRVSampling cfg = {};
+    cfg.fastForward = 200;
+    cfg.fastForwardPc = ~0u;
+    cfg.maxInstrs = 1000000;
+    cfg.window = 1000000;
+    flintRVSampler sampler(cfg);
+    ASSERT_TRUE(sampler.run(dut));
+    EXPECT_FALSE(dut.cosimMismatch());
+    ASSERT_EQ(sampler.samples().size(), 1u);
+    EXPECT_EQ(sampler.samples()[0].instret, 200u);
+    EXPECT_GE(sampler.samples()[0].cycles, sampler.samples()[0].retired);
+    EXPECT_GT(sampler.samples()[0].retired, 0u);
+    EXPECT_EQ(dut.readRegfile(S3), 362880);
+}
+
+#if FLINTRV_SAVABLE
+TEST(basic, functions_checkpoint) {
+    constexpr int memSize = 0x80000;
+    const std::string ckpt = ::testing::TempDir() + "functions.ckpt";
+    flintRV dut = flintRV(1000000, g_testTracing);
+    if (!dut.create()) {
+        FAIL();
+    }
+    if (!dut.createMemory(memSize, functions_hex, functions_hex_len)) {
+        FAIL();
+    }
+    dut.m_cpu->i_ifValid = 1;
+    dut.m_cpu->i_memValid = 1;
+    dut.writeRegfile(SP, STACK_TOP(memSize));
+    dut.writeRegfile(FP, STACK_TOP(memSize));
+
+    // Checkpoint mid-program, then finish the original run
+    ASSERT_TRUE(dut.run(500));
+    ASSERT_TRUE(dut.saveCheckpoint(ckpt));
+    vluint64_t ckptCycles = dut.cycles();
+    ASSERT_TRUE(dut.run(~(vluint64_t)0));
+
+    // A fresh harness restored from the checkpoint must end up the same
+    flintRV restored = flintRV(1000000, g_testTracing);
+    if (!restored.create()) {
+        FAIL();
+    }
+    ASSERT_TRUE(restored.restoreCheckpoint(ckpt));
+    EXPECT_EQ(restored.cycles(), ckptCycles);
+    ASSERT_TRUE(restored.run(~(vluint64_t)0));
+    std::remove(ckpt.c_str());
+
+    EXPECT_EQ(restored.cycles(), dut.cycles());
+    for (int i = 0; i < REGISTER_COUNT; ++i) {
+        EXPECT_EQ(restored.readRegfile(i), dut.readRegfile(i));
+    }
+    EXPECT_EQ(restored.readRegfile(S3), 362880);
+}
+#endif // FLINTRV_SAVABLE
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <verilated.h>
@@ -16,6 +17,7 @@
 #include "common/utils.h"
 
 #include "flintRV/flintRV.h"
+#include "flintRV/fuzz.h"
 
 namespace {
 // Embed the test programs binaries here
@@ -56,6 +58,29 @@ namespace {
 #include "sw.inc"
 #include "xor.inc"
 #include "xori.inc"
+#ifdef FLINTRV_RV32M
+#include "div.inc"
+#include "divu.inc"
+#include "mul.inc"
+#include "mulh.inc"
+#include "mulhsu.inc"
+#include "mulhu.inc"
+#include "rem.inc"
+#include "remu.inc"
+#endif // FLINTRV_RV32M
+
+// Functional tests reuse one harness (per memory size) across tests
+std::unique_ptr<flintRVPool> g_dutPool;
+
+// Owns the pool for the test program's run (i.e. the harnesses/models are
+// released when RUN_ALL_TESTS() finishes, not by static destruction)
+class DutPoolEnvironment : public ::testing::Environment {
+  public:
+    void SetUp() override { g_dutPool.reset(new flintRVPool); }
+    void TearDown() override { g_dutPool.reset(); }
+};
+::testing::Environment *const g_dutPoolEnv =
+    ::testing::AddGlobalTestEnvironment(new DutPoolEnvironment);
 } // namespace
 
 extern int g_testTracing;
@@ -63,30 +88,23 @@ extern int g_testTracing;
 #define FUNCTIONAL_TEST(name, memsize, timeout, dumplvl)                       \
     TEST(functional, name) {                                                   \
         constexpr int memSize = memsize;                                       \
-        flintRV dut = flintRV(timeout, dumplvl);                               \
-        if (!dut.create(new VflintRV(), nullptr)) {                            \
+        flintRV *dut = g_dutPool->acquire(memSize, name##_hex,                 \
+                                          name##_hex_len, timeout, dumplvl);   \
+        if (dut == nullptr) {                                                  \
             FAIL();                                                            \
         }                                                                      \
-        if (!dut.createMemory(memSize, name##_hex, name##_hex_len)) {          \
+        dut->m_cpu->i_ifValid = 1;                                             \
+        dut->m_cpu->i_memValid = 1;                                            \
+        dut->writeRegfile(SP, STACK_TOP(memSize));                             \
+        dut->writeRegfile(FP, STACK_TOP(memSize));                             \
+        if (!dut->run(~(vluint64_t)0)) {                                       \
             FAIL();                                                            \
         }                                                                      \
-        dut.m_cpu->i_ifValid = 1;                                              \
-        dut.m_cpu->i_memValid = 1;                                             \
-        dut.writeRegfile(SP, memSize - 1);                                     \
-        dut.writeRegfile(FP, memSize - 1);                                     \
-        while (!dut.end()) {                                                   \
-            if (!dut.instructionUpdate()) {                                    \
-                FAIL();                                                        \
-            }                                                                  \
-            if (!dut.loadStoreUpdate()) {                                      \
-                FAIL();                                                        \
-            }                                                                  \
-            dut.tick();                                                        \
-        }                                                                      \
+        RecordProperty("cycles", std::to_string(dut->cycles()));               \
         char resultStr[4] = {0};                                               \
-        resultStr[0] = (char)dut.readRegfile(A1);                              \
-        resultStr[1] = (char)dut.readRegfile(A2);                              \
-        resultStr[2] = (char)dut.readRegfile(A3);                              \
+        resultStr[0] = (char)dut->readRegfile(A1);                             \
+        resultStr[1] = (char)dut->readRegfile(A2);                             \
+        resultStr[2] = (char)dut->readRegfile(A3);                             \
         EXPECT_EQ(std::strcmp(resultStr, "OK"), 0)                             \
             << "resultStr: \"" << resultStr << "\"";                           \
     }
@@ -130,3 +148,27 @@ FUNCTIONAL_TEST(sub, 0x4000, 1000, g_testTracing)
 FUNCTIONAL_TEST(sw, 0x4000, 1000, g_testTracing)
 FUNCTIONAL_TEST(xor, 0x4000, 1000, g_testTracing)
 FUNCTIONAL_TEST(xori, 0x4000, 1000, g_testTracing)
+
+#ifdef FLINTRV_RV32M
+FUNCTIONAL_TEST(div, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(divu, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(mul, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(mulh, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(mulhsu, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(mulhu, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(rem, 0x4000, 10000, g_testTracing)
+FUNCTIONAL_TEST(remu, 0x4000, 10000, g_testTracing)
+#endif // FLINTRV_RV32M
+
+// Differential fuzzing smoke test (long runs use flintRV_fuzz)
+TEST(functional, fuzz_seeds) {
+    flintRVFuzzer fuzzer;
+    std::string report;
+    for (uint64_t seed = 0; seed < 64; ++seed) {
+        std::vector<uint8_t> input = fuzzSeedInput(seed);
+        EXPECT_TRUE(
+            fuzzer.run(fuzzGenerate(input.data(), input.size()), report))
+            << "seed " << seed << ":\n"
+            << report;
+    }
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "risa/librisa.h"
+
+namespace {
+// Hand-encoded RV32I instructions (no toolchain needed)
+uint32_t addi(uint32_t rd, uint32_t rs1, int32_t imm) {
+    return ((uint32_t)imm << 20) | (rs1 << 15) | (rd << 7) | 0x13;
+}
+uint32_t sw(uint32_t rs2, uint32_t rs1, int32_t imm) {
+    return (((uint32_t)imm >> 5) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (0x2 << 12) | (((uint32_t)imm & 0x1f) << 7) | 0x23;
+}
+uint32_t bne(uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 12) & 0x1) << 31) | (((u >> 5) & 0x3f) << 25) |
+           (rs2 << 20) | (rs1 << 15) | (0x1 << 12) |
+           (((u >> 1) & 0xf) << 8) | (((u >> 11) & 0x1) << 7) | 0x63;
+}
+const uint32_t ECALL = 0x00000073;
+const uint32_t EBREAK = 0x00100073;
+const uint32_t FENCE = 0x0ff0000f;
+const uint32_t LOOP = 0x0000006f; // jal x0, 0
+const uint32_t INVALID = 0xffffffff;
+
+const uint32_t A0 = 10;
+const uint32_t A1 = 11;
+const uint32_t A7 = 17;
+const uint32_t SYS_EXIT = 93;
+
+risaHart *createHart(void) {
+    risaConfig cfg = {};
+    cfg.quiet = true;
+    return risaCreate(&cfg);
+}
+
+bool load(risaHart *hart, const std::vector<uint32_t> &prog) {
+    return risaLoad(hart, prog.data(), prog.size() * sizeof(uint32_t));
+}
+} // namespace
+
+TEST(risa, ebreak) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {addi(A0, 0, 5), addi(A0, A0, 7), EBREAK}));
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_EBREAK);
+    EXPECT_EQ(risaGetReg(hart, A0), 12u);
+    EXPECT_EQ(risaGetPc(hart), 8u);
+    EXPECT_EQ(risaInstret(hart), 3u);
+    // Stops stick until the PC is moved
+    EXPECT_EQ(risaStep(hart), RISA_STOP_EBREAK);
+    EXPECT_EQ(risaInstret(hart), 3u);
+    risaDestroy(hart);
+}
+
+TEST(risa, exit) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {addi(A0, 0, 42), addi(A7, 0, SYS_EXIT), ECALL}));
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_EXIT);
+    EXPECT_EQ(risaStopped(hart), RISA_STOP_EXIT);
+    EXPECT_EQ(risaExitCode(hart), 42);
+    risaDestroy(hart);
+}
+
+TEST(risa, step) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {addi(A0, 0, 1), addi(0, 0, 9), FENCE, EBREAK}));
+    EXPECT_EQ(risaStep(hart), RISA_STOP_NONE);
+    EXPECT_EQ(risaGetPc(hart), 4u);
+    EXPECT_EQ(risaGetReg(hart, A0), 1u);
+    EXPECT_EQ(risaStep(hart), RISA_STOP_NONE);
+    EXPECT_EQ(risaGetReg(hart, 0), 0u);
+    EXPECT_EQ(risaStep(hart), RISA_STOP_NONE); // FENCE must not stop
+    EXPECT_EQ(risaStep(hart), RISA_STOP_EBREAK);
+    // Resuming past the EBREAK runs into zeroed memory (invalid)
+    risaSetPc(hart, risaGetPc(hart) + 4);
+    EXPECT_EQ(risaStopped(hart), RISA_STOP_NONE);
+    EXPECT_EQ(risaStep(hart), RISA_STOP_FAULT);
+    risaDestroy(hart);
+}
+
+TEST(risa, faults) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {INVALID}));
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_FAULT);
+    EXPECT_EQ(risaGetPc(hart), 0u);
+
+    // Store right past the end of memory
+    ASSERT_TRUE(load(hart, {sw(A0, A1, -4), EBREAK}));
+    risaSetReg(hart, A1, risaMemSize(hart) + 4);
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_FAULT);
+    EXPECT_EQ(risaInstret(hart), 0u);
+
+    // Fetch outside of memory
+    ASSERT_TRUE(load(hart, {EBREAK}));
+    risaSetPc(hart, risaMemSize(hart));
+    EXPECT_EQ(risaStep(hart), RISA_STOP_FAULT);
+
+    std::vector<uint8_t> big(risaMemSize(hart) + 1);
+    EXPECT_FALSE(risaLoad(hart, big.data(), big.size()));
+    risaDestroy(hart);
+}
+
+TEST(risa, compressedAtEnd) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    uint8_t *mem = risaMem(hart);
+    uint32_t end = risaMemSize(hart);
+    // c.ebreak in the last halfword
+    mem[end - 2] = 0x02;
+    mem[end - 1] = 0x90;
+    risaSetPc(hart, end - 2);
+    EXPECT_EQ(risaStep(hart), RISA_STOP_EBREAK);
+    // 1st half of a 32b instruction (i.e. the rest is outside of memory)
+    mem[end - 2] = 0x13;
+    mem[end - 1] = 0x00;
+    risaSetPc(hart, end - 2);
+    EXPECT_EQ(risaStep(hart), RISA_STOP_FAULT);
+    risaDestroy(hart);
+}
+
+TEST(risa, memory) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {addi(A0, 0, 0x5a), sw(A0, 0, 0x100), EBREAK}));
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_EBREAK);
+    EXPECT_EQ(risaMem(hart)[0x100], 0x5a);
+    risaDestroy(hart);
+}
+
+TEST(risa, budget) {
+    risaHart *hart = createHart();
+    ASSERT_NE(hart, nullptr);
+    ASSERT_TRUE(load(hart, {LOOP}));
+    EXPECT_EQ(risaRun(hart, 1000), RISA_STOP_BUDGET);
+    EXPECT_EQ(risaInstret(hart), 1000u);
+    EXPECT_EQ(risaStopped(hart), RISA_STOP_NONE);
+    risaDestroy(hart);
+}
+
+TEST(risa, multipleHarts) {
+    risaHart *harts[4] = {};
+    for (uint32_t i = 0; i < 4; ++i) {
+        harts[i] = createHart();
+        ASSERT_NE(harts[i], nullptr);
+        ASSERT_TRUE(load(harts[i], {addi(A0, 0, (int32_t)i),
+                                    addi(A7, 0, SYS_EXIT), ECALL}));
+    }
+    // Interleaved steps must not leak state between harts
+    for (int step = 0; step < 3; ++step) {
+        for (risaHart *hart : harts) {
+            risaStep(hart);
+        }
+    }
+    for (int32_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(risaStopped(harts[i]), RISA_STOP_EXIT);
+        EXPECT_EQ(risaExitCode(harts[i]), i);
+        risaDestroy(harts[i]);
+    }
+}
+
+TEST(risa, bbv) {
+    std::string path = ::testing::TempDir() + "risa_bbv.bb";
+    risaConfig cfg = {};
+    cfg.quiet = true;
+    cfg.bbvFile = path.c_str();
+    cfg.bbvInterval = 4;
+    risaHart *hart = risaCreate(&cfg);
+    ASSERT_NE(hart, nullptr);
+    // Blocks: 1 = [0x0, 0x8], 2 = [0x4, 0x8] (loop), 3 = [0xc] (EBREAK)
+    ASSERT_TRUE(load(hart, {addi(A0, 0, 4), addi(A0, A0, -1), bne(A0, 0, -4),
+                            EBREAK}));
+    EXPECT_EQ(risaRun(hart, 100), RISA_STOP_EBREAK);
+    EXPECT_EQ(risaInstret(hart), 10u);
+    risaDestroy(hart); // Flushes the last interval
+
+    std::ifstream in(path);
+    std::stringstream bbv;
+    bbv << in.rdbuf();
+    // Intervals end on the first block boundary past 4 instrs, and the
+    // terminating EBREAK gets its own block
+    EXPECT_EQ(bbv.str(), "T:1:3 :2:2 \nT:2:4 \nT:3:1 \n");
+    std::remove(path.c_str());
+}
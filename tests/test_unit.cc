@@ -1,9 +1,12 @@
 // Copyright (c) 2022 - present, Austin Annestrand.
 // Licensed under the MIT License (see LICENSE file).
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,16 +19,42 @@
 // Units
 #include "VALU.h"
 #include "VALU__Syms.h"
+#include "VALU_zb.h"
+#include "VALU_zb__Syms.h"
+#include "VAxiLiteBridge.h"
+#include "VAxiLiteBridge__Syms.h"
+#include "VBranchPredictor.h"
+#include "VBranchPredictor__Syms.h"
+#include "VCompressedDecoder.h"
+#include "VCompressedDecoder__Syms.h"
 #include "VControlUnit.h"
 #include "VControlUnit__Syms.h"
+#include "VControlUnit_zb.h"
+#include "VControlUnit_zb__Syms.h"
 #include "VDualPortRam.h"
 #include "VDualPortRam__Syms.h"
+#include "VICache.h"
+#include "VICache__Syms.h"
+#include "VICache_2way.h"
+#include "VICache_2way__Syms.h"
 #include "VImmGen.h"
 #include "VImmGen__Syms.h"
+#include "VMulDiv.h"
+#include "VMulDiv__Syms.h"
+#include "VMulDiv_alt.h"
+#include "VMulDiv_alt__Syms.h"
 #include "VRegfile.h"
 #include "VRegfile__Syms.h"
+#include "VWishboneBridge.h"
+#include "VWishboneBridge__Syms.h"
+// core_gen.py tops
+#include "Vaxi_top.h"
+#include "Vaxi_top__Syms.h"
+#include "Vwb_top.h"
+#include "Vwb_top__Syms.h"
 
 #include "common/utils.h"
+#include "rv32i_encode.h"
 
 #include "types.h"
 
@@ -39,7 +68,7 @@ TEST(unit, alu) {
     std::unique_ptr<VALU> dut(new VALU);
     auto p_alu = dut.get();
 
-    double TEST_OP_RANGE = 1 << 5; // 2**5
+    double TEST_OP_RANGE = 1 << 6; // 2**6
     double TEST_RANGE = 1 << 8;    // 2**8
 
     for (int i = 0; i < TEST_OP_RANGE; ++i) {
@@ -108,6 +137,778 @@ TEST(unit, alu) {
     }
 }
 
+TEST(unit, alu_zb) {
+    std::unique_ptr<VALU_zb> dut(new VALU_zb);
+    auto p_alu = dut.get();
+    // Zba/Zbb ALU ops and their instruction IDs (for the rISA model)
+    const std::vector<std::pair<int, uint32_t>> zbOps = {
+        {ALU_OP_ANDN, ANDN},       {ALU_OP_ORN, ORN},
+        {ALU_OP_XNOR, XNOR},       {ALU_OP_CLZ, CLZ},
+        {ALU_OP_CTZ, CTZ},         {ALU_OP_CPOP, CPOP},
+        {ALU_OP_MIN, MIN},         {ALU_OP_MAX, MAX},
+        {ALU_OP_MINU, MINU},       {ALU_OP_MAXU, MAXU},
+        {ALU_OP_SEXTB, SEXT_B},    {ALU_OP_SEXTH, SEXT_H},
+        {ALU_OP_ZEXTH, ZEXT_H},    {ALU_OP_ROL, ROL},
+        {ALU_OP_ROR, ROR},         {ALU_OP_ORCB, ORC_B},
+        {ALU_OP_REV8, REV8},       {ALU_OP_SH1ADD, SH1ADD},
+        {ALU_OP_SH2ADD, SH2ADD},   {ALU_OP_SH3ADD, SH3ADD},
+    };
+    auto run = [&](int op, uint32_t a, uint32_t b) {
+        p_alu->i_op = op;
+        p_alu->i_a = a;
+        p_alu->i_b = b;
+        p_alu->eval();
+        return p_alu->o_result;
+    };
+
+    // Hand-checked results
+    EXPECT_EQ(run(ALU_OP_CLZ, 0, 0), 32u);
+    EXPECT_EQ(run(ALU_OP_CLZ, 0x00010000, 0), 15u);
+    EXPECT_EQ(run(ALU_OP_CTZ, 0, 0), 32u);
+    EXPECT_EQ(run(ALU_OP_CTZ, 0x00010000, 0), 16u);
+    EXPECT_EQ(run(ALU_OP_CPOP, 0xf0f0f0f1, 0), 17u);
+    EXPECT_EQ(run(ALU_OP_MIN, 0xffffffff, 1), 0xffffffffu);
+    EXPECT_EQ(run(ALU_OP_MINU, 0xffffffff, 1), 1u);
+    EXPECT_EQ(run(ALU_OP_SEXTB, 0x180, 0), 0xffffff80u);
+    EXPECT_EQ(run(ALU_OP_ROL, 0x80000001, 1), 0x3u);
+    EXPECT_EQ(run(ALU_OP_ROR, 0x80000001, 1), 0xc0000000u);
+    EXPECT_EQ(run(ALU_OP_ROR, 0x12345678, 0), 0x12345678u);
+    EXPECT_EQ(run(ALU_OP_ORCB, 0x00100001, 0), 0x00ff00ffu);
+    EXPECT_EQ(run(ALU_OP_REV8, 0x11223344, 0), 0x44332211u);
+    EXPECT_EQ(run(ALU_OP_SH3ADD, 0x10, 1), 0x81u);
+
+    // All byte patterns at every shift position
+    constexpr int TEST_RANGE = 1 << 8; // 2**8
+    constexpr int SHIFT_RANGE = 32;
+    for (auto &op : zbOps) {
+        for (int j = 0; j < TEST_RANGE; ++j) {
+            unsigned char x = static_cast<unsigned char>(j);
+            unsigned char y = rev_byte_bits(x);
+            uint32_t a = (x << 24) | (x << 16) | (x << 8) | x;
+            uint32_t b = (y << 24) | (y << 16) | (y << 8) | y;
+            for (int sh = 0; sh < SHIFT_RANGE; ++sh) {
+                uint32_t result = run(op.first, a >> sh, b << sh);
+                EXPECT_EQ(result, executeZb(op.second, a >> sh, b << sh))
+                    << "ALU operation was: " << op.first;
+            }
+        }
+    }
+    // Base ops are unchanged w/ the extension enabled
+    std::unique_ptr<VALU> base(new VALU);
+    for (int i = 0; i < (1 << 5); ++i) {
+        for (int j = 0; j < TEST_RANGE; ++j) {
+            base->i_op = i;
+            base->i_a = j * 0x01010101;
+            base->i_b = rev_byte_bits(j) * 0x01010101;
+            base->eval();
+            EXPECT_EQ(run(i, base->i_a, base->i_b), base->o_result)
+                << "ALU operation was: " << i;
+        }
+    }
+}
+
+// Runs the RV32M vectors (and the hold/flush handshakes) against one MulDiv
+// config, checking each multi-cycle op's latency
+template <typename T> void testMulDiv(int mulCycles, int divCycles) {
+    std::unique_ptr<T> dut(new T);
+    auto p_muldiv = dut.get();
+    constexpr int TEST_OP_RANGE = 1 << 3; // 2**3 (i.e. funct3)
+    constexpr int TEST_RANGE = 1 << 8;    // 2**8
+    constexpr int MAX_OP_CYCLES = 64;
+    constexpr int OP_MUL = 0b000, OP_DIV = 0b100, OP_REM = 0b110;
+    uint32_t edge_data[] = {0x00000000, 0x00000001, 0x00000002, 0x00000007,
+                            0xffffffff, 0xfffffffe, 0x80000000, 0x7fffffff,
+                            0x80000001, 0xdeadbeef, 0x0000ffff, 0xffff0000};
+    auto tick = [](T *muldiv, int tick_count = 1) {
+        for (int i = 0; i < tick_count; ++i) {
+            muldiv->i_clk = 0;
+            muldiv->eval();
+            muldiv->i_clk = 1;
+            muldiv->eval();
+        }
+    };
+    auto gold = [](int op, uint32_t a, uint32_t b) -> uint32_t {
+        int64_t sa = static_cast<int32_t>(a);
+        int64_t sb = static_cast<int32_t>(b);
+        switch (op) {
+            case 0b000: // MUL
+                return a * b;
+            case 0b001: // MULH
+                return static_cast<uint32_t>((sa * sb) >> 32);
+            case 0b010: // MULHSU
+                return static_cast<uint32_t>((sa * static_cast<int64_t>(b)) >>
+                                             32);
+            case 0b011: // MULHU
+                return static_cast<uint32_t>(
+                    (static_cast<uint64_t>(a) * static_cast<uint64_t>(b)) >>
+                    32);
+            case 0b100: // DIV
+                return (b == 0) ? 0xffffffff
+                                : static_cast<uint32_t>(sa / sb);
+            case 0b101: // DIVU
+                return (b == 0) ? 0xffffffff : a / b;
+            case 0b110: // REM
+                return (b == 0) ? a : static_cast<uint32_t>(sa % sb);
+            case 0b111: // REMU
+            default:
+                return (b == 0) ? a : a % b;
+        }
+    };
+    auto set_op = [&](int op, uint32_t a, uint32_t b) {
+        p_muldiv->i_valid = 1;
+        p_muldiv->i_op = op;
+        p_muldiv->i_a = a;
+        p_muldiv->i_b = b;
+        p_muldiv->eval();
+    };
+    // Waits for the op's result (without leaving EXEC), returns its latency
+    auto wait_op = [&](int op, uint32_t a, uint32_t b) {
+        int cycles = 0;
+        while (p_muldiv->o_stall && cycles < MAX_OP_CYCLES) {
+            tick(p_muldiv);
+            ++cycles;
+        }
+        EXPECT_EQ(p_muldiv->o_stall, 0) << "MulDiv operation hung: " << op;
+        EXPECT_EQ(p_muldiv->o_result, gold(op, a, b))
+            << "MulDiv operation was: " << op << " (a: 0x" << std::hex << a
+            << ", b: 0x" << b << ")";
+        return cycles;
+    };
+    auto run_op = [&](int op, uint32_t a, uint32_t b) {
+        set_op(op, a, b);
+        int cycles = wait_op(op, a, b);
+        EXPECT_EQ(cycles, (op & 0b100) ? divCycles : mulCycles)
+            << "MulDiv operation was: " << op;
+        tick(p_muldiv); // Op leaves EXEC
+    };
+
+    p_muldiv->i_hold = 0;
+    p_muldiv->i_flush = 0;
+    p_muldiv->i_rst = 1;
+    tick(p_muldiv);
+    p_muldiv->i_rst = 0;
+    for (int op = 0; op < TEST_OP_RANGE; ++op) {
+        for (auto a : edge_data) {
+            for (auto b : edge_data) {
+                run_op(op, a, b);
+            }
+        }
+        for (int j = 0; j < TEST_RANGE; ++j) {
+            unsigned char x = static_cast<unsigned char>(j);
+            unsigned char y = rev_byte_bits(x);
+            run_op(op, (x << 24) | (x << 16) | (x << 8) | x,
+                   (y << 24) | (y << 16) | (y << 8) | y);
+        }
+    }
+    // Divide-by-zero and signed overflow (INT_MIN / -1)
+    run_op(OP_DIV, 0x12345678, 0x00000000);
+    run_op(OP_REM, 0x12345678, 0x00000000);
+    run_op(OP_DIV, 0x80000000, 0xffffffff);
+    run_op(OP_REM, 0x80000000, 0xffffffff);
+
+    // A stalled pipeline (i_hold) keeps a new op from starting...
+    set_op(OP_DIV, 0xdeadbeef, 0x00000007);
+    p_muldiv->i_hold = 1;
+    tick(p_muldiv, 4);
+    EXPECT_EQ(p_muldiv->o_stall, 1);
+    p_muldiv->i_hold = 0;
+    p_muldiv->eval();
+    EXPECT_EQ(wait_op(OP_DIV, 0xdeadbeef, 0x00000007), divCycles);
+    // ...and holds a finished op's result until it leaves EXEC
+    p_muldiv->i_hold = 1;
+    tick(p_muldiv, 4);
+    EXPECT_EQ(p_muldiv->o_stall, 0);
+    EXPECT_EQ(p_muldiv->o_result, gold(OP_DIV, 0xdeadbeef, 0x00000007));
+    p_muldiv->i_hold = 0;
+    tick(p_muldiv);
+
+    // A flush aborts the in-flight op, the next op starts from scratch
+    int flushOps[] = {OP_DIV, OP_MUL};
+    for (int op : flushOps) {
+        int latency = (op & 0b100) ? divCycles : mulCycles;
+        if (latency == 0) {
+            continue; // Single-cycle, nothing in flight
+        }
+        set_op(op, 0xdeadbeef, 0x00000003);
+        tick(p_muldiv, latency / 2);
+        EXPECT_EQ(p_muldiv->o_stall, 1);
+        p_muldiv->i_flush = 1;
+        tick(p_muldiv);
+        p_muldiv->i_flush = 0;
+        run_op(op, 0x00001000, 0x00000010);
+    }
+}
+
+TEST(unit, muldiv) {
+    // Single-cycle multiplier, radix-2 divider (1 bit/cycle)
+    testMulDiv<VMulDiv>(0, 33);
+}
+
+TEST(unit, muldiv_alt) {
+    // Registered multiplier, radix-4 divider (2 bits/cycle)
+    testMulDiv<VMulDiv_alt>(2, 17);
+}
+
+TEST(unit, branch_predictor) {
+    std::unique_ptr<VBranchPredictor> dut(new VBranchPredictor);
+    auto p_bp = dut.get();
+    constexpr uint32_t BRA_PC = 0x100, BRA_TARGET = 0x80;
+    constexpr uint32_t JMP_PC = 0x204, JMP_TARGET = 0x1000;
+    constexpr uint32_t ALIAS_PC = BRA_PC + (16 << 2); // Same BTB index, new tag
+    auto tick = [](VBranchPredictor *bp, int tick_count = 1) {
+        for (int i = 0; i < tick_count; ++i) {
+            bp->i_clk = 0;
+            bp->eval();
+            bp->i_clk = 1;
+            bp->eval();
+        }
+    };
+    auto update = [&](uint32_t pc, bool bra, bool jmp, bool taken,
+                      uint32_t target) {
+        p_bp->i_update = 1;
+        p_bp->i_updateBra = bra;
+        p_bp->i_updateJmp = jmp;
+        p_bp->i_updateTaken = taken;
+        p_bp->i_updatePC = pc;
+        p_bp->i_updateTarget = target;
+        tick(p_bp);
+        p_bp->i_update = 0;
+    };
+    auto predict = [&](uint32_t pc) {
+        p_bp->i_fetchPC = pc;
+        p_bp->eval();
+        return p_bp->o_predTaken;
+    };
+
+    p_bp->i_update = 0;
+    p_bp->i_rst = 1;
+    tick(p_bp);
+    p_bp->i_rst = 0;
+    // Cold BTB predicts not-taken
+    EXPECT_EQ(predict(BRA_PC), 0);
+    EXPECT_EQ(predict(JMP_PC), 0);
+    // Taken branch trains weakly-taken and allocates the BTB entry
+    update(BRA_PC, true, false, true, BRA_TARGET);
+    EXPECT_EQ(predict(BRA_PC), 1);
+    EXPECT_EQ(p_bp->o_predTarget, BRA_TARGET);
+    EXPECT_EQ(predict(ALIAS_PC), 0);
+    // Saturate taken, then needs two not-taken outcomes to flip
+    update(BRA_PC, true, false, true, BRA_TARGET);
+    update(BRA_PC, true, false, true, BRA_TARGET);
+    update(BRA_PC, true, false, false, BRA_TARGET);
+    EXPECT_EQ(predict(BRA_PC), 1);
+    update(BRA_PC, true, false, false, BRA_TARGET);
+    EXPECT_EQ(predict(BRA_PC), 0);
+    // Jumps are always predicted taken on a BTB hit
+    update(JMP_PC, false, true, true, JMP_TARGET);
+    EXPECT_EQ(predict(JMP_PC), 1);
+    EXPECT_EQ(p_bp->o_predTarget, JMP_TARGET);
+    // Stale entry (mispredicted non-branch) gets dropped
+    update(JMP_PC, false, false, false, 0);
+    EXPECT_EQ(predict(JMP_PC), 0);
+    // Reset clears the BTB
+    update(BRA_PC, true, false, true, BRA_TARGET);
+    EXPECT_EQ(predict(BRA_PC), 1);
+    p_bp->i_rst = 1;
+    tick(p_bp);
+    p_bp->i_rst = 0;
+    EXPECT_EQ(predict(BRA_PC), 0);
+}
+
+namespace {
+// Bus slave models (word-addressed memory w/ a fixed number of wait states
+// before each handshake) - drive() sets the slave's outputs for the current
+// cycle, edge() completes its handshakes at the clock edge
+struct BusSlave {
+    BusSlave(std::vector<uint32_t> &mem, int waitStates)
+        : mem(mem), waitStates(waitStates) {}
+    virtual ~BusSlave() {}
+    virtual void drive() = 0;
+    virtual void edge() = 0;
+    std::vector<uint32_t> &mem;
+    int waitStates;
+    // Completed accesses
+    int accesses = 0;
+    uint32_t lastAddr = 0;
+    bool lastWrite = false;
+    uint32_t lastStrb = 0;
+
+  protected:
+    uint32_t &word(uint32_t addr) { return mem[(addr >> 2) % mem.size()]; }
+    void complete(uint32_t addr, bool write, uint32_t data, uint32_t strb) {
+        if (write) {
+            for (int i = 0; i < 4; ++i) {
+                if (strb & (1 << i)) {
+                    word(addr) = (word(addr) & ~(0xffu << (8 * i))) |
+                                 (data & (0xffu << (8 * i)));
+                }
+            }
+        }
+        ++accesses;
+        lastAddr = addr;
+        lastWrite = write;
+        lastStrb = strb;
+    }
+};
+
+// Wishbone B4 (classic) slave - acks after waitStates cycles of CYC/STB
+struct WishboneSlave : BusSlave {
+    WishboneSlave(std::vector<uint32_t> &mem, int waitStates, const CData &cyc,
+                  const CData &stb, const CData &we, const IData &adr,
+                  const IData &datOut, const CData &sel, IData &datIn,
+                  CData &ack)
+        : BusSlave(mem, waitStates), cyc(cyc), stb(stb), we(we), adr(adr),
+          datOut(datOut), sel(sel), datIn(datIn), ack(ack) {}
+    void drive() override {
+        ack = cyc && stb && (count >= waitStates);
+        datIn = word(adr);
+    }
+    void edge() override {
+        if (ack) {
+            complete(adr, we, datOut, sel);
+            count = 0;
+        } else if (cyc && stb) {
+            ++count;
+        } else {
+            count = 0;
+        }
+    }
+    const CData &cyc, &stb, &we;
+    const IData &adr, &datOut;
+    const CData &sel;
+    IData &datIn;
+    CData &ack;
+    int count = 0;
+};
+#define WB_PORT(dut, bus)                                                      \
+    (dut)->o_##bus##_cyc, (dut)->o_##bus##_stb, (dut)->o_##bus##_we,           \
+        (dut)->o_##bus##_adr, (dut)->o_##bus##_dat, (dut)->o_##bus##_sel,      \
+        (dut)->i_##bus##_dat, (dut)->i_##bus##_ack
+
+// AXI4-Lite slave - each channel handshakes after waitStates cycles (W lags
+// AW by a cycle, so the two complete independently), writes land on the B
+// handshake
+struct AxiLiteSlave : BusSlave {
+    AxiLiteSlave(std::vector<uint32_t> &mem, int waitStates,
+                 const CData &arvalid, const IData &araddr, CData &arready,
+                 IData &rdata, CData &rvalid, const CData &rready)
+        : BusSlave(mem, waitStates), arvalid(&arvalid), araddr(&araddr),
+          arready(&arready), rdata(&rdata), rvalid(&rvalid), rready(&rready) {
+    }
+    AxiLiteSlave(std::vector<uint32_t> &mem, int waitStates,
+                 const CData &arvalid, const IData &araddr, CData &arready,
+                 IData &rdata, CData &rvalid, const CData &rready,
+                 const CData &awvalid, const IData &awaddr, CData &awready,
+                 const CData &wvalid, const IData &wdata, const CData &wstrb,
+                 CData &wready, CData &bvalid, const CData &bready)
+        : AxiLiteSlave(mem, waitStates, arvalid, araddr, arready, rdata,
+                       rvalid, rready) {
+        this->awvalid = &awvalid;
+        this->awaddr = &awaddr;
+        this->awready = &awready;
+        this->wvalid = &wvalid;
+        this->wdata = &wdata;
+        this->wstrb = &wstrb;
+        this->wready = &wready;
+        this->bvalid = &bvalid;
+        this->bready = &bready;
+    }
+    void drive() override {
+        *arready = *arvalid && !rPending && (arCount >= waitStates);
+        *rvalid = rPending && (rCount >= waitStates);
+        *rdata = word(rAddr);
+        if (awvalid != nullptr) {
+            *awready = *awvalid && !awDone && (awCount >= waitStates);
+            *wready = *wvalid && !wDone && (wCount >= waitStates + 1);
+            *bvalid = awDone && wDone && (bCount >= waitStates);
+        }
+    }
+    void edge() override {
+        if (*rvalid && *rready) {
+            complete(rAddr, false, 0, 0xf);
+            rPending = false;
+        } else if (rPending) {
+            ++rCount;
+        }
+        if (*arready) {
+            rPending = true;
+            rAddr = *araddr;
+            rCount = arCount = 0;
+        } else if (*arvalid) {
+            ++arCount;
+        }
+        if (awvalid == nullptr) {
+            return;
+        }
+        if (*bvalid && *bready) {
+            complete(awAddr, true, wData, wStrb);
+            awDone = wDone = false;
+            bCount = 0;
+        } else if (awDone && wDone) {
+            ++bCount;
+        }
+        if (*awready) {
+            awDone = true;
+            awAddr = *awaddr;
+            awCount = 0;
+        } else if (*awvalid) {
+            ++awCount;
+        }
+        if (*wready) {
+            wDone = true;
+            wData = *wdata;
+            wStrb = *wstrb;
+            wCount = 0;
+        } else if (*wvalid) {
+            ++wCount;
+        }
+    }
+    // Read channels
+    const CData *arvalid;
+    const IData *araddr;
+    CData *arready;
+    IData *rdata;
+    CData *rvalid;
+    const CData *rready;
+    // Write channels (nullptr for a read-only port)
+    const CData *awvalid = nullptr;
+    const IData *awaddr = nullptr;
+    CData *awready = nullptr;
+    const CData *wvalid = nullptr;
+    const IData *wdata = nullptr;
+    const CData *wstrb = nullptr;
+    CData *wready = nullptr;
+    CData *bvalid = nullptr;
+    const CData *bready = nullptr;
+    int arCount = 0, rCount = 0, awCount = 0, wCount = 0, bCount = 0;
+    bool rPending = false, awDone = false, wDone = false;
+    uint32_t rAddr = 0, awAddr = 0, wData = 0, wStrb = 0;
+};
+#define AXI_READ_PORT(dut, bus)                                                \
+    (dut)->o_##bus##_arvalid, (dut)->o_##bus##_araddr,                         \
+        (dut)->i_##bus##_arready, (dut)->i_##bus##_rdata,                      \
+        (dut)->i_##bus##_rvalid, (dut)->o_##bus##_rready
+#define AXI_WRITE_PORT(dut, bus)                                               \
+    (dut)->o_##bus##_awvalid, (dut)->o_##bus##_awaddr,                         \
+        (dut)->i_##bus##_awready, (dut)->o_##bus##_wvalid,                     \
+        (dut)->o_##bus##_wdata, (dut)->o_##bus##_wstrb,                        \
+        (dut)->i_##bus##_wready, (dut)->i_##bus##_bvalid,                      \
+        (dut)->o_##bus##_bready
+
+std::vector<uint32_t> busTestMemory() {
+    std::vector<uint32_t> mem(1024);
+    for (size_t i = 0; i < mem.size(); ++i) {
+        mem[i] = 0xc0de0000 | static_cast<uint32_t>(i);
+    }
+    return mem;
+}
+
+// Settles the slaves' outputs for the cycle (before the clock edge)
+template <typename T>
+void busSettle(T *dut, std::initializer_list<BusSlave *> slaves) {
+    dut->i_clk = 0;
+    dut->eval();
+    for (auto slave : slaves) {
+        slave->drive();
+    }
+    dut->eval();
+}
+
+template <typename T>
+void busEdge(T *dut, std::initializer_list<BusSlave *> slaves) {
+    for (auto slave : slaves) {
+        slave->edge();
+    }
+    dut->i_clk = 1;
+    dut->eval();
+}
+
+// Core-port accesses through a bus bridge: reads, byte-strobed writes and a
+// request redirected while the bus is busy
+template <typename T>
+void testBusBridge(T *dut, BusSlave &slave, int readCycles, int writeCycles) {
+    constexpr int MAX_ACCESS_CYCLES = 64;
+    std::vector<uint32_t> &mem = slave.mem;
+    auto settle = [&]() { busSettle(dut, {&slave}); };
+    auto edge = [&]() { busEdge(dut, {&slave}); };
+    // Returns the number of cycles until the access completed
+    auto access = [&](bool we, uint32_t addr, uint32_t data, uint32_t byteEn,
+                      uint32_t *rdata) {
+        int cycles = 0;
+        dut->i_req = 1;
+        dut->i_we = we;
+        dut->i_addr = addr;
+        dut->i_data = data;
+        dut->i_byteEn = byteEn;
+        settle();
+        while (!dut->o_valid && cycles < MAX_ACCESS_CYCLES) {
+            edge();
+            settle();
+            ++cycles;
+        }
+        EXPECT_EQ(dut->o_valid, 1) << "Access hung at: 0x" << std::hex
+                                   << addr;
+        if (rdata != nullptr) {
+            *rdata = dut->o_data;
+        }
+        edge();
+        dut->i_req = 0;
+        EXPECT_EQ(slave.lastAddr, addr);
+        EXPECT_EQ(slave.lastWrite, we);
+        EXPECT_EQ(slave.lastStrb, we ? byteEn : 0xf);
+        return cycles;
+    };
+
+    dut->i_req = 0;
+    dut->i_rst = 1;
+    settle();
+    edge();
+    dut->i_rst = 0;
+    uint32_t data = 0;
+    EXPECT_EQ(access(false, 0x10, 0, 0xf, &data), readCycles);
+    EXPECT_EQ(data, mem[0x10 >> 2]);
+    EXPECT_EQ(access(true, 0x20, 0x11223344, 0xf, nullptr), writeCycles);
+    EXPECT_EQ(mem[0x20 >> 2], 0x11223344u);
+    EXPECT_EQ(access(false, 0x20, 0, 0xf, &data), readCycles);
+    EXPECT_EQ(data, 0x11223344u);
+    // Byte/halfword stores (data is already lane-shifted by the core)
+    struct {
+        uint32_t byteEn;
+        uint32_t mask;
+    } strobes[] = {{0x1, 0x000000ff}, {0x2, 0x0000ff00}, {0x4, 0x00ff0000},
+                   {0x8, 0xff000000}, {0x3, 0x0000ffff}, {0xc, 0xffff0000}};
+    uint32_t addr = 0x40;
+    for (auto &strobe : strobes) {
+        uint32_t expected =
+            (mem[addr >> 2] & ~strobe.mask) | (0xaabbccdd & strobe.mask);
+        access(true, addr, 0xaabbccdd, strobe.byteEn, nullptr);
+        EXPECT_EQ(mem[addr >> 2], expected)
+            << "Byte enables were: " << strobe.byteEn;
+        addr += 4;
+    }
+
+    // The core moves on (e.g. fetch redirect) before the bus responds - the
+    // stale response is dropped, then the new request goes out
+    int accesses = slave.accesses;
+    dut->i_req = 1;
+    dut->i_we = 0;
+    dut->i_addr = 0x80;
+    settle();
+    edge();
+    dut->i_addr = 0x84;
+    settle();
+    int cycles = 0;
+    while (!dut->o_valid && cycles < MAX_ACCESS_CYCLES) {
+        edge();
+        settle();
+        ++cycles;
+    }
+    EXPECT_EQ(dut->o_valid, 1);
+    EXPECT_EQ(dut->o_data, mem[0x84 >> 2]);
+    EXPECT_EQ(slave.accesses, accesses + 1); // The stale read finished
+    edge();
+    dut->i_req = 0;
+    EXPECT_EQ(slave.lastAddr, 0x84u);
+}
+} // namespace
+
+TEST(unit, wishbone_bridge) {
+    for (int waitStates : {0, 1, 3}) {
+        std::unique_ptr<VWishboneBridge> dut(new VWishboneBridge);
+        auto p_wb = dut.get();
+        std::vector<uint32_t> mem = busTestMemory();
+        WishboneSlave slave(mem, waitStates, WB_PORT(p_wb, wb));
+        // Request registered, then waitStates before the ack
+        testBusBridge(p_wb, slave, 1 + waitStates, 1 + waitStates);
+    }
+}
+
+TEST(unit, axilite_bridge) {
+    for (int waitStates : {0, 1, 3}) {
+        std::unique_ptr<VAxiLiteBridge> dut(new VAxiLiteBridge);
+        auto p_axi = dut.get();
+        std::vector<uint32_t> mem = busTestMemory();
+        AxiLiteSlave slave(mem, waitStates, AXI_READ_PORT(p_axi, axi),
+                           AXI_WRITE_PORT(p_axi, axi));
+        // Address then response handshake (W lags AW by a cycle)
+        testBusBridge(p_axi, slave, 2 + 2 * waitStates, 3 + 2 * waitStates);
+        EXPECT_EQ(p_axi->o_axi_arprot, 0); // Data port
+        EXPECT_EQ(p_axi->o_axi_awprot, 0);
+    }
+}
+
+// Hit/miss/refill (w/ refill wait states) and replacement of one I$ config
+template <typename T> void testICache(int ways, int waitStates) {
+    std::unique_ptr<T> dut(new T);
+    auto p_icache = dut.get();
+    constexpr int LINE_WORDS = 4;            // LINE_ADDR_WIDTH = 2
+    constexpr uint32_t WAY_BYTES = 16 * 16;  // 16 sets x 16B lines
+    constexpr int MAX_MISS_CYCLES = 256;
+    const int missCycles = 1 + LINE_WORDS * (1 + waitStates);
+    std::vector<uint32_t> mem = busTestMemory();
+    int memWait = 0;
+    auto tick = [&](T *icache, int tick_count = 1) {
+        for (int i = 0; i < tick_count; ++i) {
+            icache->i_clk = 0;
+            icache->eval();
+            // Memory behind the refill port (waitStates per word)
+            if (icache->i_memValid) {
+                memWait = 0;
+            } else if (icache->o_memReq) {
+                ++memWait;
+            }
+            icache->i_clk = 1;
+            icache->eval();
+        }
+    };
+    auto memUpdate = [&]() {
+        p_icache->eval();
+        p_icache->i_memValid =
+            p_icache->o_memReq && (memWait >= waitStates);
+        p_icache->i_memData = mem[(p_icache->o_memAddr >> 2) % mem.size()];
+        p_icache->eval();
+    };
+    // Returns the number of stall cycles before the fetch hit
+    auto fetch = [&](uint32_t addr) {
+        int cycles = 0;
+        p_icache->i_addr = addr;
+        memUpdate();
+        while (!p_icache->o_valid && cycles < MAX_MISS_CYCLES) {
+            tick(p_icache);
+            memUpdate();
+            ++cycles;
+        }
+        EXPECT_EQ(p_icache->o_valid, 1) << "Fetch hung at: 0x" << std::hex
+                                        << addr;
+        EXPECT_EQ(p_icache->o_data, mem[addr >> 2]);
+        tick(p_icache);
+        return cycles;
+    };
+
+    p_icache->i_memValid = 0;
+    p_icache->i_rst = 1;
+    tick(p_icache);
+    p_icache->i_rst = 0;
+    // Cold miss refills the whole line, rest of the line hits
+    EXPECT_EQ(fetch(0x0), missCycles);
+    for (uint32_t addr = 0x4; addr < LINE_WORDS * 4; addr += 4) {
+        EXPECT_EQ(fetch(addr), 0);
+    }
+    // Sequential sweep over the whole cache, then everything hits
+    for (uint32_t addr = 0; addr < WAY_BYTES * ways; addr += 4) {
+        fetch(addr);
+    }
+    for (uint32_t addr = 0; addr < WAY_BYTES * ways; addr += 4) {
+        EXPECT_EQ(fetch(addr), 0);
+    }
+    if (ways == 1) {
+        // Conflicting line (same set) evicts
+        EXPECT_EQ(fetch(WAY_BYTES), missCycles);
+        EXPECT_EQ(fetch(0x0), missCycles);
+    } else {
+        // Set 0 holds 0x0 and WAY_BYTES - touching 0x0 keeps it resident,
+        // conflicting lines take turns in the other way
+        EXPECT_EQ(fetch(0x0), 0);
+        EXPECT_EQ(fetch(2 * WAY_BYTES), missCycles);
+        EXPECT_EQ(fetch(0x0), 0);
+        EXPECT_EQ(fetch(WAY_BYTES), missCycles);
+        EXPECT_EQ(fetch(0x0), 0);
+        EXPECT_EQ(fetch(2 * WAY_BYTES), missCycles);
+    }
+    // Reset invalidates
+    p_icache->i_rst = 1;
+    tick(p_icache);
+    p_icache->i_rst = 0;
+    EXPECT_EQ(fetch(0x0), missCycles);
+}
+
+TEST(unit, icache) {
+    for (int waitStates : {0, 2}) {
+        testICache<VICache>(1, waitStates);
+    }
+}
+
+TEST(unit, icache_2way) {
+    for (int waitStates : {0, 2}) {
+        testICache<VICache_2way>(2, waitStates);
+    }
+}
+
+namespace {
+// Loop, word/byte stores and loads - leaves {55, 0x1122ab44, 55, 0xab} at
+// BUS_TEST_RESULT (the word at +4 starts as 0x11223344)
+constexpr uint32_t BUS_TEST_RESULT = 0x100;
+std::vector<uint32_t> busTestProgram() {
+    using namespace rv32i;
+    return {addi(1, 0, 0),      addi(2, 0, 10),     add(1, 1, 2),
+            addi(2, 2, -1),     bne(2, 0, -8),      sw(1, 0, 0x100),
+            addi(3, 0, 0xab),   sb(3, 0, 0x105),    lw(4, 0, 0x100),
+            sw(4, 0, 0x108),    lbu(5, 0, 0x105),   sw(5, 0, 0x10c),
+            jal(0, 0)};
+}
+
+// Runs busTestProgram() on a core_gen.py top (w/ the I$ in front of ibus)
+template <typename T>
+void testCoreGenTop(T *dut, std::vector<uint32_t> &mem, BusSlave &ibus,
+                    BusSlave &dbus) {
+    constexpr int MAX_CYCLES = 10000;
+    constexpr int ICACHE_LINE_WORDS = 4;
+    std::vector<uint32_t> prog = busTestProgram();
+    std::copy(prog.begin(), prog.end(), mem.begin());
+    const size_t result = BUS_TEST_RESULT >> 2;
+    mem[result + 1] = 0x11223344;
+    mem[result + 3] = 0;
+    auto tick = [&]() {
+        busSettle(dut, {&ibus, &dbus});
+        busEdge(dut, {&ibus, &dbus});
+    };
+
+    dut->i_rst = 1;
+    for (int i = 0; i < 4; ++i) {
+        tick();
+    }
+    dut->i_rst = 0;
+    int cycles = 0;
+    while (mem[result + 3] != 0xab && cycles < MAX_CYCLES) {
+        tick();
+        ++cycles;
+    }
+    EXPECT_LT(cycles, MAX_CYCLES) << "Program did not finish";
+    EXPECT_EQ(mem[result], 55u);
+    EXPECT_EQ(mem[result + 1], 0x1122ab44u);
+    EXPECT_EQ(mem[result + 2], 55u);
+    EXPECT_EQ(mem[result + 3], 0xabu);
+    // The loop runs out of the I$ (only the program's lines, plus at most
+    // one line fetched past the end, are refilled)
+    int programLines = (prog.size() + ICACHE_LINE_WORDS - 1) /
+                       ICACHE_LINE_WORDS;
+    EXPECT_LE(ibus.accesses, (programLines + 1) * ICACHE_LINE_WORDS);
+    EXPECT_GT(dbus.accesses, 0);
+}
+} // namespace
+
+TEST(unit, core_gen_wishbone) {
+    // core_gen.py -if wishbone -icache dm
+    std::unique_ptr<Vwb_top> dut(new Vwb_top);
+    auto p_top = dut.get();
+    std::vector<uint32_t> mem = busTestMemory();
+    WishboneSlave ibus(mem, 2, WB_PORT(p_top, iwb));
+    WishboneSlave dbus(mem, 1, WB_PORT(p_top, dwb));
+    testCoreGenTop(p_top, mem, ibus, dbus);
+}
+
+TEST(unit, core_gen_axi4lite) {
+    // core_gen.py -if axi4lite -icache 2way
+    std::unique_ptr<Vaxi_top> dut(new Vaxi_top);
+    auto p_top = dut.get();
+    std::vector<uint32_t> mem = busTestMemory();
+    AxiLiteSlave ibus(mem, 2, AXI_READ_PORT(p_top, iaxi));
+    AxiLiteSlave dbus(mem, 1, AXI_READ_PORT(p_top, daxi),
+                      AXI_WRITE_PORT(p_top, daxi));
+    testCoreGenTop(p_top, mem, ibus, dbus);
+    EXPECT_EQ(p_top->o_iaxi_arprot, 0x4); // Instruction port
+}
+
 TEST(unit, regfile) {
     std::unique_ptr<VRegfile> dut(new VRegfile);
     auto p_regfile = dut.get();
@@ -278,6 +1079,44 @@ TEST(unit, immgen) {
     }
 }
 
+TEST(unit, compressed_decoder) {
+    std::unique_ptr<VCompressedDecoder> dut(new VCompressedDecoder);
+    auto p_rvc = dut.get();
+    // Hand-checked expansions (from the assembler/spec tables)
+    std::vector<std::pair<uint16_t, uint32_t>> vectors = {
+        {0x1141, 0xff010113}, // c.addi sp, sp, -16
+        {0x0808, 0x01010513}, // c.addi4spn a0, sp, 16
+        {0x41c8, 0x0045a503}, // c.lw a0, 4(a1)
+        {0xc606, 0x00112623}, // c.swsp ra, 12(sp)
+        {0x4515, 0x00500513}, // c.li a0, 5
+        {0x65c1, 0x000105b7}, // c.lui a1, 0x10
+        {0x6105, 0x02010113}, // c.addi16sp sp, 32
+        {0x8d89, 0x40a585b3}, // c.sub a1, a1, a0
+        {0x852e, 0x00b00533}, // c.mv a0, a1
+        {0x952e, 0x00b50533}, // c.add a0, a0, a1
+        {0xc501, 0x00050463}, // c.beqz a0, +8
+        {0x3ff5, 0xffdff0ef}, // c.jal -4
+        {0xa001, 0x0000006f}, // c.j 0
+        {0x8082, 0x00008067}, // c.jr ra
+        {0x9002, 0x00100073}, // c.ebreak
+        {0x0000, 0x00000000}, // Defined illegal
+    };
+    for (auto &v : vectors) {
+        p_rvc->i_instr = v.first;
+        p_rvc->eval();
+        EXPECT_EQ(p_rvc->o_instr, v.second) << std::hex << v.first;
+    }
+    // Exhaustive check against the rISA expander (quadrant 3 is not RVC)
+    for (uint32_t i = 0; i < (1 << 16); ++i) {
+        if (!IS_COMPRESSED(i)) {
+            continue;
+        }
+        p_rvc->i_instr = i;
+        p_rvc->eval();
+        EXPECT_EQ(p_rvc->o_instr, expandCompressed(i)) << std::hex << i;
+    }
+}
+
 TEST(unit, ctrl_unit_rv32i) {
     std::unique_ptr<VControlUnit> dut(new VControlUnit);
     auto p_ctrl = dut.get();
@@ -466,3 +1305,94 @@ TEST(unit, ctrl_unit_rv32i) {
         EXPECT_EQ(p_ctrl->o_ctrlSigs, ctl_gold);
     }
 }
+
+TEST(unit, ctrl_unit_zb) {
+    std::unique_ptr<VControlUnit_zb> dut(new VControlUnit_zb);
+    std::unique_ptr<VControlUnit> base(new VControlUnit);
+    auto p_ctrl = dut.get();
+    auto CTRL = UNIT(p_ctrl)->ControlUnit;
+    constexpr int TEST_COUNT = 1 << 15; // 2**15 (funct7, funct3, rs2)
+
+    // Zba/Zbb decode (-1 if not a Zba/Zbb instruction)
+    auto zbGold = [&](int opcode, int funct7, int funct3, int rs2) -> int64_t {
+        if (opcode == OP_MAP_OP) {
+            switch (funct7 << 3 | funct3) {
+                case 0b0100000 << 3 | 0b111:
+                    return CTRL->ANDN;
+                case 0b0100000 << 3 | 0b110:
+                    return CTRL->ORN;
+                case 0b0100000 << 3 | 0b100:
+                    return CTRL->XNOR;
+                case 0b0000101 << 3 | 0b100:
+                    return CTRL->MIN;
+                case 0b0000101 << 3 | 0b101:
+                    return CTRL->MINU;
+                case 0b0000101 << 3 | 0b110:
+                    return CTRL->MAX;
+                case 0b0000101 << 3 | 0b111:
+                    return CTRL->MAXU;
+                case 0b0110000 << 3 | 0b001:
+                    return CTRL->ROL;
+                case 0b0110000 << 3 | 0b101:
+                    return CTRL->ROR;
+                case 0b0000100 << 3 | 0b100:
+                    return (rs2 == 0) ? CTRL->ZEXTH : -1;
+                case 0b0010000 << 3 | 0b010:
+                    return CTRL->SH1ADD;
+                case 0b0010000 << 3 | 0b100:
+                    return CTRL->SH2ADD;
+                case 0b0010000 << 3 | 0b110:
+                    return CTRL->SH3ADD;
+                default:
+                    return -1;
+            }
+        }
+        if (opcode == OP_MAP_OP_IMM) {
+            if (funct7 == 0b0110000 && funct3 == 0b001) {
+                switch (rs2) {
+                    case 0b00000:
+                        return CTRL->CLZ;
+                    case 0b00001:
+                        return CTRL->CTZ;
+                    case 0b00010:
+                        return CTRL->CPOP;
+                    case 0b00100:
+                        return CTRL->SEXTB;
+                    case 0b00101:
+                        return CTRL->SEXTH;
+                    default:
+                        return -1;
+                }
+            }
+            if (funct7 == 0b0110000 && funct3 == 0b101) {
+                return CTRL->RORI;
+            }
+            if (funct7 == 0b0010100 && funct3 == 0b101 && rs2 == 0b00111) {
+                return CTRL->ORCB;
+            }
+            if (funct7 == 0b0110100 && funct3 == 0b101 && rs2 == 0b11000) {
+                return CTRL->REV8;
+            }
+        }
+        return -1;
+    };
+
+    for (int opcode : {OP_MAP_OP, OP_MAP_OP_IMM}) {
+        for (int instr = 0; instr < TEST_COUNT; ++instr) {
+            p_ctrl->i_opcode = base->i_opcode = opcode;
+            p_ctrl->i_funct3 = base->i_funct3 = get_bits(instr, 0, 3);
+            p_ctrl->i_funct7 = base->i_funct7 = get_bits(instr, 3, 7);
+            p_ctrl->i_rs2 = base->i_rs2 = get_bits(instr, 10, 5);
+            p_ctrl->eval();
+            base->eval();
+            // Non-Zba/Zbb encodings decode as they do w/o the extension
+            int64_t ctl_gold = zbGold(opcode, p_ctrl->i_funct7,
+                                      p_ctrl->i_funct3, p_ctrl->i_rs2);
+            EXPECT_EQ(p_ctrl->o_ctrlSigs,
+                      (ctl_gold < 0) ? base->o_ctrlSigs : ctl_gold)
+                << std::hex << "funct7: " << (int)p_ctrl->i_funct7
+                << ", funct3: " << (int)p_ctrl->i_funct3
+                << ", rs2: " << (int)p_ctrl->i_rs2;
+        }
+    }
+}
@@ -0,0 +1,210 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+// Clean-room CoreMark-style workload (not EEMBC CoreMark, so its scores are
+// not comparable): linked list search/reversal, integer matrix multiply and a
+// number-parsing state machine, all folded into a CRC16 checksum
+
+#include <stdint.h>
+
+#include "report.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 10
+#endif // ITERATIONS
+
+#define LIST_LEN 64
+#define MAT_N 8
+#define INPUT_LEN 256
+
+void _start(void);
+void _flintRV_start(void) {
+    _start();
+    for (;;)
+        ;
+}
+
+// CRC-16/ARC (reflected 0x8005) of the low bits of data
+uint16_t crc16(uint16_t crc, uint32_t data, int bits) {
+    for (int i = 0; i < bits; ++i) {
+        uint16_t lsb = (crc ^ data) & 1;
+        crc >>= 1;
+        data >>= 1;
+        if (lsb) {
+            crc ^= 0xa001;
+        }
+    }
+    return crc;
+}
+
+// Linear congruential generator (the program's only source of input data)
+uint32_t nextRand(uint32_t *state) {
+    *state = *state * 1103515245u + 12345u;
+    return *state >> 16;
+}
+
+// --- Linked list ---
+typedef struct node {
+    struct node *next;
+    int16_t key;
+    int16_t val;
+} node_t;
+
+node_t nodes[LIST_LEN];
+
+node_t *listInit(uint32_t *seed) {
+    for (int i = 0; i < LIST_LEN; ++i) {
+        nodes[i].next = (i + 1 < LIST_LEN) ? &nodes[i + 1] : 0;
+        nodes[i].key = (int16_t)i;
+        nodes[i].val = (int16_t)(nextRand(seed) & 0x7fff);
+    }
+    return &nodes[0];
+}
+
+node_t *listReverse(node_t *head) {
+    node_t *prev = 0;
+    while (head != 0) {
+        node_t *next = head->next;
+        head->next = prev;
+        prev = head;
+        head = next;
+    }
+    return prev;
+}
+
+node_t *listFind(node_t *head, int16_t key) {
+    while (head != 0 && head->key != key) {
+        head = head->next;
+    }
+    return head;
+}
+
+uint16_t listBench(node_t **head, uint32_t *seed, uint16_t crc) {
+    for (int i = 0; i < 8; ++i) {
+        int16_t key = (int16_t)(nextRand(seed) % (LIST_LEN + 8));
+        node_t *found = listFind(*head, key);
+        if (found != 0) {
+            found->val = (int16_t)((found->val ^ key) & 0x7fff);
+            crc = crc16(crc, (uint32_t)found->val, 16);
+        } else {
+            crc = crc16(crc, (uint32_t)key, 8);
+        }
+        *head = listReverse(*head);
+    }
+    return crc;
+}
+
+// --- Matrix ---
+int16_t matA[MAT_N][MAT_N];
+int16_t matB[MAT_N][MAT_N];
+int32_t matC[MAT_N][MAT_N];
+
+uint16_t matrixBench(uint32_t *seed, uint16_t crc) {
+    for (int i = 0; i < MAT_N; ++i) {
+        for (int j = 0; j < MAT_N; ++j) {
+            matA[i][j] = (int16_t)((nextRand(seed) & 0xff) - 0x80);
+            matB[i][j] = (int16_t)((nextRand(seed) & 0xff) - 0x80);
+        }
+    }
+    for (int i = 0; i < MAT_N; ++i) {
+        for (int j = 0; j < MAT_N; ++j) {
+            int32_t sum = 0;
+            for (int k = 0; k < MAT_N; ++k) {
+                sum += (int32_t)matA[i][k] * matB[k][j];
+            }
+            matC[i][j] = sum;
+        }
+    }
+    // Fold in the sum of the positive-result rows (data dependent branches)
+    for (int i = 0; i < MAT_N; ++i) {
+        int32_t rowSum = 0;
+        for (int j = 0; j < MAT_N; ++j) {
+            if (matC[i][j] > 0) {
+                rowSum += matC[i][j];
+            }
+        }
+        crc = crc16(crc, (uint32_t)rowSum, 32);
+    }
+    return crc;
+}
+
+// --- State machine ---
+typedef enum {
+    ST_START,
+    ST_INT,
+    ST_FRAC,
+    ST_EXP,
+    ST_INVALID,
+    ST_COUNT
+} state_t;
+
+char input[INPUT_LEN];
+
+state_t nextState(state_t state, char c) {
+    int isDigit = (c >= '0' && c <= '9');
+    switch (state) {
+        case ST_START:
+            if (isDigit || c == '-') {
+                return ST_INT;
+            }
+            return (c == '.') ? ST_FRAC : ST_INVALID;
+        case ST_INT:
+            if (isDigit) {
+                return ST_INT;
+            }
+            if (c == '.') {
+                return ST_FRAC;
+            }
+            return (c == 'e') ? ST_EXP : ST_INVALID;
+        case ST_FRAC:
+            if (isDigit) {
+                return ST_FRAC;
+            }
+            return (c == 'e') ? ST_EXP : ST_INVALID;
+        case ST_EXP:
+            return (isDigit || c == '-') ? ST_EXP : ST_INVALID;
+        default:
+            return ST_INVALID;
+    }
+}
+
+uint16_t stateBench(uint32_t *seed, uint16_t crc) {
+    static const char alphabet[] = "0123456789012345.e-,,x";
+    uint32_t counts[ST_COUNT] = {0};
+    for (int i = 0; i < INPUT_LEN; ++i) {
+        input[i] = alphabet[nextRand(seed) % (sizeof(alphabet) - 1)];
+    }
+    // Comma separated tokens, counted by their final state
+    state_t state = ST_START;
+    for (int i = 0; i < INPUT_LEN; ++i) {
+        if (input[i] == ',') {
+            counts[state]++;
+            state = ST_START;
+        } else {
+            state = nextState(state, input[i]);
+        }
+    }
+    counts[state]++;
+    for (int i = 0; i < ST_COUNT; ++i) {
+        crc = crc16(crc, counts[i], 16);
+    }
+    return crc;
+}
+
+int main(void) {
+    uint32_t seed = 0x3415;
+    uint16_t crc = 0;
+    node_t *head = listInit(&seed);
+    for (int i = 0; i < ITERATIONS; ++i) {
+        crc = listBench(&head, &seed, crc);
+        crc = matrixBench(&seed, crc);
+        crc = stateBench(&seed, crc);
+    }
+    reportResult("coremark_lite", ITERATIONS, crc);
+
+    // Pass back the iteration count and checksum to the simulator
+    register long s1 asm("s1") = ITERATIONS;
+    register long s2 asm("s2") = crc;
+    asm("ebreak");
+    return 0;
+}
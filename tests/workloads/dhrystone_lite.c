@@ -0,0 +1,198 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+// Clean-room Dhrystone-style workload (not Dhrystone 2.1, so its scores are
+// not comparable): record copies, fixed-size string copy/compare, enum and
+// character functions, small integer arithmetic (incl. mul/div) and array
+// updates through many short procedure calls
+
+#include <stdint.h>
+
+#include "report.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 500
+#endif // ITERATIONS
+
+#define STR_LEN 31
+#define ARR_LEN 16
+
+void _start(void);
+void _flintRV_start(void) {
+    _start();
+    for (;;)
+        ;
+}
+
+typedef enum { IDENT_1, IDENT_2, IDENT_3, IDENT_4, IDENT_5 } ident_t;
+
+typedef struct record {
+    struct record *ptrComp;
+    ident_t discr;
+    ident_t enumComp;
+    int32_t intComp;
+    char strComp[STR_LEN];
+} record_t;
+
+record_t recGlob, recNext;
+int32_t intGlob;
+int32_t boolGlob;
+char char1Glob, char2Glob;
+int32_t arr1Glob[ARR_LEN];
+int32_t arr2Glob[ARR_LEN][ARR_LEN];
+
+void strCopy(char *dst, const char *src) {
+    while ((*dst++ = *src++) != '\0')
+        ;
+}
+
+int32_t strCompare(const char *a, const char *b) {
+    while (*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return (int32_t)(unsigned char)*a - (int32_t)(unsigned char)*b;
+}
+
+ident_t funcChar(char c1, char c2) {
+    if (c1 != c2) {
+        return IDENT_1;
+    }
+    char1Glob = c1;
+    return IDENT_2;
+}
+
+int32_t funcIdent(ident_t ident) { return ident == IDENT_3; }
+
+int32_t funcStrings(const char *s1, const char *s2) {
+    int32_t idx = 2;
+    char c = 'A';
+    while (idx <= 2) {
+        if (funcChar(s1[idx], s2[idx + 1]) == IDENT_1) {
+            c = 'A';
+            idx++;
+        }
+    }
+    if (c >= 'W' && c < 'Z') {
+        idx = 7;
+    }
+    if (c == 'R') {
+        return 1;
+    }
+    if (strCompare(s1, s2) > 0) {
+        intGlob = idx + 7;
+        return 1;
+    }
+    return 0;
+}
+
+void procIdent(ident_t in, ident_t *out) {
+    *out = in;
+    if (!funcIdent(in)) {
+        *out = IDENT_4;
+    }
+    switch (in) {
+        case IDENT_1:
+            *out = IDENT_1;
+            break;
+        case IDENT_2:
+            *out = (intGlob > 100) ? IDENT_1 : IDENT_4;
+            break;
+        case IDENT_3:
+            *out = IDENT_2;
+            break;
+        case IDENT_5:
+            *out = IDENT_3;
+            break;
+        default:
+            break;
+    }
+}
+
+void procInt(int32_t a, int32_t b, int32_t *out) { *out = b + a + 2; }
+
+void procArrays(int32_t arr1[], int32_t arr2[][ARR_LEN], int32_t a,
+                int32_t b) {
+    int32_t idx = (a + 5) % ARR_LEN;
+    arr1[idx] = b;
+    arr1[(idx + 1) % ARR_LEN] = arr1[idx];
+    arr1[(idx + 7) % ARR_LEN] = idx;
+    for (int32_t i = idx; i <= idx + 1; ++i) {
+        arr2[idx][i % ARR_LEN] = idx;
+    }
+    arr2[idx][(idx + ARR_LEN - 1) % ARR_LEN] += 1;
+    arr2[(idx + 4) % ARR_LEN][idx] = arr1[idx];
+    intGlob = 5;
+}
+
+void procRecord(record_t *rec) {
+    record_t *next = rec->ptrComp;
+    *next = *rec; // Record copy
+    rec->intComp = 5;
+    next->intComp = rec->intComp;
+    next->ptrComp = rec->ptrComp;
+    if (next->discr == IDENT_1) {
+        next->intComp = 6;
+        procIdent(rec->enumComp, &next->enumComp);
+        next->ptrComp = recGlob.ptrComp;
+        procInt(next->intComp, 10, &next->intComp);
+    } else {
+        *rec = *next;
+    }
+}
+
+int main(void) {
+    char str1[STR_LEN], str2[STR_LEN];
+    uint32_t checksum = 0;
+
+    recGlob.ptrComp = &recNext;
+    recGlob.discr = IDENT_1;
+    recGlob.enumComp = IDENT_3;
+    recGlob.intComp = 40;
+    strCopy(recGlob.strComp, "DHRYSTONE-LITE, SOME STRING");
+    strCopy(str1, "DHRYSTONE-LITE, 1'ST STRING");
+
+    for (int32_t run = 1; run <= ITERATIONS; ++run) {
+        int32_t int1 = 2, int2 = 3, int3 = 0;
+        ident_t ident = IDENT_2;
+        char1Glob = 'A';
+        char2Glob = 'B';
+        strCopy(str2, "DHRYSTONE-LITE, 2'ND STRING");
+        boolGlob = !funcStrings(str1, str2);
+        while (int1 < int2) {
+            int3 = 5 * int1 - int2;
+            procInt(int1, int2, &int3);
+            int1++;
+        }
+        procArrays(arr1Glob, arr2Glob, int1, int3);
+        procRecord(&recGlob);
+        for (char c = 'A'; c <= char2Glob; ++c) {
+            if (ident == funcChar(c, 'C')) {
+                procIdent(IDENT_1, &ident);
+                strCopy(str2, "DHRYSTONE-LITE, 3'RD STRING");
+                int2 = run;
+                intGlob = run;
+            }
+        }
+        int2 = int2 * int1;
+        int1 = int2 / int3;
+        int2 = 7 * (int2 - int3) - int1;
+        procInt(int1, int2, &int1);
+
+        checksum = checksum * 31 + (uint32_t)(int1 + int2 + int3 + intGlob);
+        checksum = checksum * 31 + (uint32_t)(ident + recNext.intComp);
+        checksum = checksum * 31 + (uint32_t)(char1Glob + str2[16]);
+    }
+    for (int i = 0; i < ARR_LEN; ++i) {
+        checksum = checksum * 31 + (uint32_t)arr1Glob[i];
+        checksum = checksum * 31 + (uint32_t)arr2Glob[i][i];
+    }
+
+    reportResult("dhrystone_lite", ITERATIONS, checksum);
+
+    // Pass back the iteration count and checksum to the simulator
+    register long s1 asm("s1") = ITERATIONS;
+    register long s2 asm("s2") = checksum;
+    asm("ebreak");
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2023 - present, Austin Annestrand.
+// Licensed under the MIT License (see LICENSE file).
+
+#pragma once
+
+#include <stdint.h>
+
+// Syscalls (taken from "riscv64-unknown-elf/include/machine/syscall.h")
+#define SYS_write 64
+
+static void sysWrite(const char *buf, long len) {
+    register long a0 asm("a0") = 1; // stdout
+    register long a1 asm("a1") = (long)buf;
+    register long a2 asm("a2") = len;
+    register long a7 asm("a7") = SYS_write;
+    asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a2), "r"(a7) : "memory");
+}
+
+static int appendStr(char *buf, int pos, const char *str) {
+    while (*str != '\0') {
+        buf[pos++] = *str++;
+    }
+    return pos;
+}
+
+static int appendUint(char *buf, int pos, uint32_t val, uint32_t base) {
+    char digits[10];
+    int len = 0;
+    do {
+        uint32_t digit = val % base;
+        digits[len++] = (char)((digit < 10) ? '0' + digit : 'a' + digit - 10);
+        val /= base;
+    } while (val != 0);
+    while (len > 0) {
+        buf[pos++] = digits[--len];
+    }
+    return pos;
+}
+
+// Prints "<name>: <N> iterations, checksum 0x<checksum>" (parsed by
+// scripts/workload_bench.py) through the simulators' SYS_write emulation
+static void reportResult(const char *name, uint32_t iterations,
+                         uint32_t checksum) {
+    char buf[96];
+    int pos = appendStr(buf, 0, name);
+    pos = appendStr(buf, pos, ": ");
+    pos = appendUint(buf, pos, iterations, 10);
+    pos = appendStr(buf, pos, " iterations, checksum 0x");
+    pos = appendUint(buf, pos, checksum, 16);
+    buf[pos++] = '\n';
+    sysWrite(buf, pos);
+}